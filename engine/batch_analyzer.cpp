@@ -0,0 +1,123 @@
+#include "batch_analyzer.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+BatchAnalyzer::BatchAnalyzer(int thread_number, const SearchLimits &limits):
+thread_number{thread_number}, limits{limits}{
+    //positions are searched in parallel, not the moves of one position
+    this->limits.threads = 1;
+    for(int i = 0; i < thread_number; i++){
+        workers.push_back(std::unique_ptr<Engine>(new Engine()));
+    }
+}
+
+void BatchAnalyzer::run(std::istream &fin, std::ostream &fout){
+    StateReader reader(fin, SIZE);
+    run_chunks([&](std::pair<int, ChessBoard> &position){
+        if(!reader.next(position.first, position.second)){
+            if(!fin.eof()) std::cerr << "incomplete board after position " << positions.size() << std::endl;
+            return false;
+        }
+        return true;
+    }, fout);
+}
+
+void BatchAnalyzer::run(const CorpusReader &corpus, std::ostream &fout){
+    size_t next = 0;
+    run_chunks([&](std::pair<int, ChessBoard> &position){
+        if(next >= corpus.size()) return false;
+        position.first = corpus[next].player;
+        position.second = decode_board(corpus[next]);
+        next++;
+        return true;
+    }, fout);
+}
+
+void BatchAnalyzer::run_chunks(std::function<bool(std::pair<int, ChessBoard> &)> read_position, std::ostream &fout){
+    //positions are read and written a chunk at a time so the input can be any size
+    bool end_of_input = false;
+    while(!end_of_input){
+        positions.clear();
+        while(positions.size() < CHUNK_SIZE){
+            std::pair<int, ChessBoard> position;
+            if(!read_position(position)){
+                end_of_input = true;
+                break;
+            }
+            positions.push_back(position);
+        }
+
+        lines = std::vector<std::string>(positions.size());
+        next_position = 0;
+        std::vector<std::thread> threads;
+        for(int i = 0; i < thread_number; i++){
+            threads.push_back(std::thread(&BatchAnalyzer::search_chunk, this, i));
+        }
+        for(auto &thread:threads){
+            thread.join();
+        }
+        for(auto &line:lines){
+            fout << line << '\n';
+        }
+    }
+    fout.flush();
+}
+
+void BatchAnalyzer::search_chunk(int worker){
+    Engine &engine = *workers[worker];
+    for(size_t i = next_position++; i < positions.size(); i = next_position++){
+        engine.set_position(positions[i].first, positions[i].second);
+        lines[i] = format_result(engine.search(limits));
+    }
+}
+
+std::string BatchAnalyzer::format_result(const SearchResult &result) const{
+    //x y score depth nodes, then the principal variation as x y pairs
+    std::stringstream ss;
+    ss << result.best_move.x << ' ' << result.best_move.y << ' ' << result.value << ' ' << result.depth << ' ' << result.nodes;
+    for(auto &step:result.pv){
+        ss << ' ' << step.x << ' ' << step.y;
+    }
+    return ss.str();
+}
+
+int run_batch(int argc, char **argv){
+    if(argc < 4){
+        std::cerr << "usage: " << argv[0] << " --batch <positions or corpus> <output> [--threads N] [--nodes N] [--time ms] [--time-us us] [--beam K]" << std::endl;
+        return 1;
+    }
+    int thread_number = std::max(1u, std::thread::hardware_concurrency());
+    SearchLimits limits;
+    for(int i = 4; i + 1 < argc; i += 2){
+        std::string option = argv[i];
+        if(option == "--threads") thread_number = std::max(1, atoi(argv[i+1]));
+        else if(option == "--nodes") limits.nodes = atoll(argv[i+1]);
+        else if(option == "--time") limits.time = atoi(argv[i+1]);
+        else if(option == "--time-us") limits.time_us = atoll(argv[i+1]);
+        else if(option == "--beam") limits.beam_width = atoi(argv[i+1]);
+        else std::cerr << "unknown option " << option << std::endl;
+    }
+
+    std::ofstream fout(argv[3]);
+    BatchAnalyzer analyzer(thread_number, limits);
+    if(CorpusReader::is_corpus(argv[2])){
+        CorpusReader corpus;
+        if(!corpus.open(argv[2]) || !fout){
+            std::cerr << "can't open " << argv[2] << " or " << argv[3] << std::endl;
+            return 1;
+        }
+        analyzer.run(corpus, fout);
+        return 0;
+    }
+    std::ifstream fin(argv[2]);
+    if(!fin || !fout){
+        std::cerr << "can't open " << argv[2] << " or " << argv[3] << std::endl;
+        return 1;
+    }
+    analyzer.run(fin, fout);
+    return 0;
+}
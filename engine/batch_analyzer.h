@@ -0,0 +1,41 @@
+#ifndef GOBANG_BATCH_ANALYZER_H
+#define GOBANG_BATCH_ANALYZER_H
+
+#include <atomic>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "chess_board.h"
+#include "engine.h"
+#include "position_corpus.h"
+
+class BatchAnalyzer{
+    //search every position of a file, positions are written like the state file one after another
+    //each worker keeps its own Engine so nothing is built again between positions
+    public:
+        BatchAnalyzer(int thread_number, const SearchLimits &limits);
+        void run(std::istream &fin, std::ostream &fout);
+        void run(const CorpusReader &corpus, std::ostream &fout);
+    private:
+        void run_chunks(std::function<bool(std::pair<int, ChessBoard> &)> read_position, std::ostream &fout);
+        void search_chunk(int worker);
+        std::string format_result(const SearchResult &result) const;
+        const int SIZE = 15;
+        const size_t CHUNK_SIZE = 4096;
+        int thread_number;
+        SearchLimits limits;
+        std::vector<std::unique_ptr<Engine>> workers;
+        //current chunk
+        std::vector<std::pair<int, ChessBoard>> positions;
+        std::vector<std::string> lines;
+        std::atomic<size_t> next_position;
+};
+
+//my_player --batch <positions or corpus> <output> [--threads N] [--nodes N] [--time ms] [--time-us us] [--beam K]
+int run_batch(int argc, char **argv);
+
+#endif
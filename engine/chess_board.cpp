@@ -0,0 +1,199 @@
+#include "chess_board.h"
+
+#include <random>
+#include <sstream>
+#include <string>
+
+ChessBoard::ChessBoard(int size, std::istream &fin): SIZE{size}{
+    int input;
+    board = std::vector<std::vector<int>>(SIZE);
+    for (int i = 0; i < SIZE; i++) {
+        for (int j = 0; j < SIZE; j++) {
+            fin >> input;
+            board[i].push_back(input);
+            if(input != 0) update_hashes(i, j, input);
+        }
+    }
+}
+
+ChessBoard::ChessBoard(const std::vector<std::vector<int>> &board): SIZE{(int)board.size()}, board{board}{
+    for(int x = 0; x < SIZE; x++){
+        for(int y = 0; y < SIZE; y++){
+            if(board[x][y] != 0) update_hashes(x, y, board[x][y]);
+        }
+    }
+}
+
+unsigned long long ChessBoard::zobrist_key(int x, int y, int player){
+    //one fixed random number for every cell and player of boards up to 32x32
+    //the same in every run so hashes can be saved
+    static const std::vector<unsigned long long> keys = [](){
+        std::mt19937_64 generator(20240501);
+        std::vector<unsigned long long> keys(2*32*32);
+        for(auto &key:keys){
+            key = generator();
+        }
+        return keys;
+    }();
+    return keys[((player - 1)*32 + x)*32 + y];
+}
+
+unsigned long long ChessBoard::get_hash() const{
+    return hashes[0];
+}
+
+void ChessBoard::update_hashes(int x, int y, int player){
+    //adds or removes the piece, xor is its own inverse
+    for(int symmetry = 0; symmetry < SYMMETRY_NUMBER; symmetry++){
+        Point point = transform(Point(x, y), symmetry);
+        hashes[symmetry] ^= zobrist_key(point.x, point.y, player);
+    }
+}
+
+Point ChessBoard::transform(const Point &point, int symmetry) const{
+    //swap the axes if bit 2 is set, then flip x for bit 0 and y for bit 1
+    Point result = (symmetry & 4) ? Point(point.y, point.x) : point;
+    if(symmetry & 1) result.x = SIZE - 1 - result.x;
+    if(symmetry & 2) result.y = SIZE - 1 - result.y;
+    return result;
+}
+
+Point ChessBoard::inverse_transform(const Point &point, int symmetry) const{
+    //the flips then the swap
+    Point result = point;
+    if(symmetry & 1) result.x = SIZE - 1 - result.x;
+    if(symmetry & 2) result.y = SIZE - 1 - result.y;
+    return (symmetry & 4) ? Point(result.y, result.x) : result;
+}
+
+std::vector<int> ChessBoard::symmetries() const{
+    //the symmetries (not the identity) that leave the board as it is
+    //for most boards the hashes already differ, the cells are only compared when they are the same
+    std::vector<int> found;
+    for(int symmetry = 1; symmetry < SYMMETRY_NUMBER; symmetry++){
+        if(hashes[symmetry] != hashes[0]) continue;
+        bool same = true;
+        for(int x = 0; x < SIZE && same; x++){
+            for(int y = 0; y < SIZE && same; y++){
+                Point point = transform(Point(x, y), symmetry);
+                same = board[point.x][point.y] == board[x][y];
+            }
+        }
+        if(same) found.push_back(symmetry);
+    }
+    return found;
+}
+
+unsigned long long ChessBoard::get_canonical_hash(int &symmetry) const{
+    //the same for every board that is a symmetry of another one
+    //symmetry is the one that turns this board into the canonical board
+    symmetry = 0;
+    for(int i = 1; i < SYMMETRY_NUMBER; i++){
+        if(hashes[i] < hashes[symmetry]) symmetry = i;
+    }
+    return hashes[symmetry];
+}
+
+void ChessBoard::add_piece(Point &point, int player){
+    add_piece(point.x, point.y, player);
+}
+
+void ChessBoard::delete_piece(Point &point){
+    delete_piece(point.x, point.y);
+}
+
+bool ChessBoard::is_valid(Point &point) const{
+    return point.x >= 0 && point.x < SIZE && point.y >= 0 && point.y < SIZE && board[point.x][point.y] == 0;
+}
+
+bool ChessBoard::is_empty(Point &point) const{
+    return board[point.x][point.y] == 0;
+}
+
+void ChessBoard::add_piece(int x, int y, int player){
+    board[x][y] = player;
+    update_hashes(x, y, player);
+    if(network) network->update(x, y, player);
+}
+void ChessBoard::delete_piece(int x, int y){
+    if(board[x][y] != 0) update_hashes(x, y, board[x][y]);
+    board[x][y] = 0;
+    if(network) network->update(x, y, 0);
+}
+
+bool ChessBoard::is_valid(int x, int y) const{
+    return x >= 0 && x < SIZE && y >= 0 && y < SIZE && board[x][y] == 0;
+}
+
+bool ChessBoard::is_empty(int x, int y) const{
+    return board[x][y] == 0;
+}
+
+std::vector<int> &ChessBoard::operator[](int i){
+    return board[i];
+}
+
+const std::vector<int> &ChessBoard::operator[](int i) const{
+    return board[i];
+}
+
+void ChessBoard::print() const{
+    std::cout << "---- Chess Board ----" << std::endl;
+    std::cout << "  ";
+    for(int i = 0; i < SIZE; i++){
+        std::cout << i%10 << ' ';
+    }
+    std::cout << std::endl;
+    for(int x = 0; x < SIZE; x++){
+        std::cout << x%10 << ' ';
+        for(int y = 0; y < SIZE; y++){
+            if(board[x][y] == 0){
+                std::cout << '.' << ' ';
+            }
+            else{
+                std::cout << board[x][y] << ' ';
+            }
+        }
+        std::cout << std::endl;
+    }
+}
+
+// ----- State Reader ----- //
+
+StateReader::StateReader(std::istream &fin, int size): fin(fin), size{size} {};
+
+bool StateReader::next(int &player, ChessBoard &board){
+    if(has_player){
+        player = next_player;
+        has_player = false;
+    }
+    else if(!(fin >> player)){
+        return false;
+    }
+    board = ChessBoard(size, fin);
+    if(!fin) return false;
+
+    //the time line has three numbers, the player line of the next position only one
+    has_times = false;
+    std::string line;
+    std::getline(fin, line); //the end of the last row
+    while(std::getline(fin, line)){
+        std::stringstream ss(line);
+        long long values[3];
+        int number = 0;
+        while(number < 3 && ss >> values[number]) number++;
+        if(number == 0) continue;
+        if(number == 3){
+            has_times = true;
+            game_time = values[0];
+            increment = values[1];
+            move_time = values[2];
+        }
+        else{
+            has_player = true;
+            next_player = (int)values[0];
+        }
+        break;
+    }
+    return true;
+}
@@ -0,0 +1,65 @@
+#ifndef GOBANG_CHESS_BOARD_H
+#define GOBANG_CHESS_BOARD_H
+
+#include <iostream>
+#include <vector>
+
+#include "point.h"
+#include "pattern_network.h"
+
+class ChessBoard{
+    public:
+        ChessBoard() {};
+        ChessBoard(int size, std::istream &fin);
+        ChessBoard(const std::vector<std::vector<int>> &board);
+        void add_piece(Point &point, int player);
+        void delete_piece(Point &point);
+        bool is_valid(Point &point) const;
+        bool is_empty(Point &point) const;
+        void add_piece(int x, int y, int player);
+        void delete_piece(int x, int y);
+        bool is_valid(int x, int y) const;
+        bool is_empty(int x, int y) const;
+        void print() const;
+        std::vector<int> &operator[](int i);
+        const std::vector<int> &operator[](int i) const;
+        unsigned long long get_hash() const;
+        static unsigned long long zobrist_key(int x, int y, int player);
+        //the 8 symmetries of the square board, 0 is the identity
+        static const int SYMMETRY_NUMBER = 8;
+        Point transform(const Point &point, int symmetry) const;
+        Point inverse_transform(const Point &point, int symmetry) const;
+        std::vector<int> symmetries() const;
+        unsigned long long get_canonical_hash(int &symmetry) const;
+
+        friend class DecisionMaker;
+        friend class WeightTuner;
+        friend class ProofSolver;
+    private:
+        int SIZE;
+        std::vector<std::vector<int>> board;
+        PatternNetwork *network = nullptr; //told about every change if set
+        void update_hashes(int x, int y, int player);
+        //zobrist hash of the board seen through each symmetry, kept up to date by add_piece and delete_piece
+        unsigned long long hashes[SYMMETRY_NUMBER] = {};
+};
+
+class StateReader{
+    //positions written like the state file one after another: the player on its own line then the board
+    //the referee may add a line with the time left (ms) after the board: whole game(-1 if no limit), increment, this move
+    public:
+        StateReader(std::istream &fin, int size);
+        bool next(int &player, ChessBoard &board);
+        bool has_times = false; //of the last position read
+        long long game_time = -1;
+        long long increment = 0;
+        long long move_time = -1;
+    private:
+        std::istream &fin;
+        int size;
+        //the line after a board without times is the player of the next position
+        bool has_player = false;
+        int next_player = 0;
+};
+
+#endif
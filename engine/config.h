@@ -0,0 +1,24 @@
+#ifndef GOBANG_CONFIG_H
+#define GOBANG_CONFIG_H
+
+#define _DEPTH 5 //search_depth of a search without a depth, time or node limit
+#define MAX_DEPTH 64 //plies iterative deepening can reach before a time or node limit stops it
+#define SITUAION_NUMBER 5
+#define LMR_FULL_MOVES 4 //moves searched to full depth before reducing
+#define LMR_REDUCTION 1
+#define LMR_DEEP_MOVES 10 //moves after this one are reduced by one more ply
+#define LMP_MOVES 12 //quiet moves after this one are not searched two plies above the leaves
+#define FUTILITY_MARGIN 300.0 //in evaluator units, scaled for the pattern network
+#define WIN_SCORE 1e7 //a finished five less the plies to it, above anything an evaluator gives
+#define WEIGHTS_FILE "weights.txt" //written by --tune, loaded at startup if it exists
+#define PATTERN_WEIGHTS_FILE "patterns.bin" //pattern network used instead of the evaluator if it exists
+#define PATTERN_HIDDEN 32 //must be a multiple of 16
+#define SOLVER_TABLE_SIZE (1 << 18) //proof search hash table entries, must be a power of 2
+#define SOLVER_NODES 5000 //proof search before every move of my_player, 0 to turn it off
+#define CACHE_ENV "GOBANG_CACHE" //environment variable with the search cache file, no cache if not set
+#define CACHE_ENTRIES (1 << 20) //24 bytes each, must be a power of 2
+#define TRACE_ENV "GOBANG_TRACE" //environment variable with the search trace file, no tracing if not set
+#define TRACE_EVENTS (1 << 18) //last events kept of every thread, 32 bytes each
+#define SERVER_SLICE 20 //ms a server search runs before the other sessions get their turn, doubled each time a depth is cut off
+
+#endif
@@ -0,0 +1,765 @@
+#include "decision_maker.h"
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+
+DecisionMaker::DecisionMaker(){
+    evaluator = Evaluator(SIZE, 1);
+    evaluator.load_weights(WEIGHTS_FILE);
+    std::shared_ptr<const PatternWeights> pattern_weights = PatternWeights::shared();
+    use_network = (pattern_weights != nullptr);
+    if(use_network){
+        network = PatternNetwork(SIZE, pattern_weights);
+    }
+    threat_detector = ThreatDetector(SIZE);
+    score_scale = use_network ? measure_score_scale() : 1.0f;
+    init_directions();
+}
+
+void DecisionMaker::set_position(int player, const ChessBoard &board){
+    //everything built in the constructor is kept, only the position is replaced
+    this->player = player;
+    enemy = (player == 1) ? 2:1;
+    evaluator.set_player(player);
+    root = StateTreeNode(player);
+    this->board = board;
+    this->board.network = nullptr;
+    if(use_network){
+        network.refresh(this->board.board);
+        this->board.network = &network;
+    }
+}
+
+void DecisionMaker::set_cache(SearchCache *cache){
+    this->cache = cache;
+}
+
+void DecisionMaker::set_trace(SearchTrace *trace){
+    this->trace = trace;
+}
+
+static unsigned long long hash_bytes(unsigned long long hash, const void *data, size_t size){
+    //fnv-1a
+    const unsigned char *bytes = (const unsigned char *)data;
+    for(size_t i = 0; i < size; i++){
+        hash = (hash ^ bytes[i])*0x100000001b3ULL;
+    }
+    return hash;
+}
+
+unsigned long long DecisionMaker::evaluation_hash() const{
+    //what a searched value depends on besides the position: the loaded weights, the pattern network and the search constants
+    unsigned long long hash = 0xcbf29ce484222325ULL;
+    std::vector<float> weights = evaluator.weights();
+    hash = hash_bytes(hash, weights.data(), weights.size()*sizeof(float));
+    const float constants[] = {LMR_FULL_MOVES, LMR_REDUCTION, LMR_DEEP_MOVES, LMP_MOVES, FUTILITY_MARGIN, WIN_SCORE, score_scale};
+    hash = hash_bytes(hash, constants, sizeof(constants));
+    std::shared_ptr<const PatternWeights> pattern_weights = PatternWeights::shared();
+    if(use_network && pattern_weights){
+        hash = hash_bytes(hash, pattern_weights->bias, sizeof(pattern_weights->bias));
+        hash = hash_bytes(hash, pattern_weights->windows, sizeof(pattern_weights->windows));
+        hash = hash_bytes(hash, pattern_weights->output, sizeof(pattern_weights->output));
+        hash = hash_bytes(hash, &pattern_weights->output_bias, sizeof(pattern_weights->output_bias));
+        hash = hash_bytes(hash, &pattern_weights->output_divisor, sizeof(pattern_weights->output_divisor));
+    }
+    return hash;
+}
+
+void DecisionMaker::create_root(){
+    //create tree
+    root = StateTreeNode(player);
+    possible_step_set.clear();
+    get_all_possible_steps();
+    //print_possible_steps();  
+    create_tree(root, player);
+}
+
+std::vector<Point> DecisionMaker::root_moves(){
+    //the root moves in the order they are searched
+    create_root();
+    std::vector<Point> moves;
+    for(auto &child:root.childs){
+        moves.push_back(child.placement);
+    }
+    return moves;
+}
+
+void DecisionMaker::start_search(const SearchLimits &limits){
+    node_limit = limits.nodes;
+    time_limit = limits.time*1000LL;
+    if(limits.time_us > 0){
+        time_limit = (time_limit > 0) ? std::min(time_limit, limits.time_us) : limits.time_us;
+    }
+    exact_deadline = limits.time_us > 0;
+    stop_flag = limits.stop;
+    beam_width = std::max(0, limits.beam_width);
+    multi_pv = std::max(1, limits.multi_pv);
+    start_time = std::chrono::steady_clock::now();
+    nodes = 0;
+    stopped = false;
+    for(auto &ply_killers:killers){
+        ply_killers.clear();
+    }
+    create_root();
+    if(!limits.root_moves.empty()){
+        root.childs.erase(std::remove_if(root.childs.begin(), root.childs.end(), [&](const StateTreeNode &child){
+            return std::find(limits.root_moves.begin(), limits.root_moves.end(), child.placement) == limits.root_moves.end();
+        }), root.childs.end());
+    }
+    if(beam_width > 0 && root.childs.size() > beam_width){
+        root.childs.resize(beam_width);
+    }
+}
+
+SearchResult DecisionMaker::empty_result() const{
+    //the first root move until a search finishes, (-1, -1) if the board is full
+    SearchResult result;
+    result.best_move = root.childs.empty() ? Point(-1, -1) : root.childs.front().placement;
+    return result;
+}
+
+int DecisionMaker::max_search_depth(const SearchLimits &limits) const{
+    //a time or node limit ends the deepening by itself, only a search without any limit has a fixed depth
+    if(limits.depth > 0) return std::min(MAX_DEPTH, limits.depth) + 1;
+    if(limits.time > 0 || limits.time_us > 0 || limits.nodes > 0 || limits.stop) return MAX_DEPTH + 1;
+    return DEPTH;
+}
+
+bool DecisionMaker::search_root(SearchResult &result, const std::vector<PVLine> &finished_lines){
+    //search the root to search_depth, result is only changed if the search finishes
+    //finished_lines are root moves already searched to this depth, the others only have to beat them
+    root_lines = finished_lines;
+    if(pv_table.size() < (size_t)search_depth + 1){
+        pv_table.resize(search_depth + 1);
+        killers.resize(search_depth + 1);
+    }
+    std::vector<StateTreeNode> finished;
+    for(auto &line:finished_lines){
+        auto child = std::find_if(root.childs.begin(), root.childs.end(), [&line](const StateTreeNode &child){
+            return child.placement == line.move;
+        });
+        if(child != root.childs.end()){
+            child->value = line.value;
+            finished.push_back(*child);
+            root.childs.erase(child);
+        }
+    }
+    //use alpha-beta pruning to get next step
+    float final_value = -std::numeric_limits<float>::max();
+    if(!root.childs.empty()){
+        final_value = alpha_beta_pruning(root, 1, 0, root_alpha(), std::numeric_limits<float>::max(), true);
+    }
+    root.childs.insert(root.childs.begin(), finished.begin(), finished.end());
+    if(stopped){
+        //the best move so far: the best move of the last depth is searched first,
+        //once it finished the root moves that finished after it are compared with it at the new depth
+        auto best = std::max_element(root_lines.begin(), root_lines.end(), [](const PVLine &a, const PVLine &b){
+            return a.value < b.value;
+        });
+        if(best != root_lines.end() && (result.depth == 0 || root_lines.front().move == result.best_move)){
+            result.best_move = best->move;
+            result.value = best->value;
+            result.pv = best->pv;
+        }
+        return false;
+    }
+
+    auto best_finished = std::max_element(finished_lines.begin(), finished_lines.end(), [](const PVLine &a, const PVLine &b){
+        return a.value < b.value;
+    });
+    if(best_finished != finished_lines.end() && (pv_table[0].empty() || best_finished->value >= final_value)){
+        final_value = best_finished->value;
+        pv_table[0] = best_finished->pv;
+    }
+    result.value = final_value;
+    result.depth = search_depth - 1;
+    result.pv = pv_table[0];
+    if(!result.pv.empty()){
+        result.best_move = result.pv.front();
+    }
+    std::stable_sort(root_lines.begin(), root_lines.end(), [](const PVLine &a, const PVLine &b){
+        return a.value > b.value;
+    });
+    result.lines.assign(root_lines.begin(), root_lines.begin() + std::min<size_t>(multi_pv, root_lines.size()));
+
+    //the best childs of this search are searched first in the next one
+    std::stable_sort(root.childs.begin(), root.childs.end(), [](const StateTreeNode &a, const StateTreeNode &b){
+        return a.value > b.value;
+    });
+    return true;
+}
+
+SearchResult DecisionMaker::search(const SearchLimits &limits, std::function<void(const SearchResult &)> on_iteration){
+    start_search(limits);
+    SearchResult result = empty_result();
+    if(root.childs.empty()){
+        //board is full
+        return result;
+    }
+
+    //iterative deepening, an unfinished search is thrown away so there is always a move to return
+    int max_depth = max_search_depth(limits);
+    for(search_depth = 2; search_depth <= max_depth; search_depth++){
+        if(!search_root(result, std::vector<PVLine>())) break;
+        result.nodes = nodes;
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+        if(on_iteration) on_iteration(result);
+    }
+    result.nodes = nodes;
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    return result;
+}
+
+void DecisionMaker::search_iteration(const SearchLimits &limits, SearchContinuation &continuation){
+    //one depth of iterative deepening, the position must be set first
+    //a depth that was stopped goes on from the root moves it finished, the best move found before it was stopped is kept
+    //everything kept from the depth before is in the continuation, so any DecisionMaker can do the next one
+    start_search(limits);
+    if(!continuation.killers.empty()){
+        killers = continuation.killers;
+    }
+    if(continuation.depth == 2 && !continuation.stopped){
+        continuation.result = empty_result();
+    }
+    if(!continuation.root_order.empty()){
+        std::vector<Point> &order = continuation.root_order;
+        std::stable_sort(root.childs.begin(), root.childs.end(), [&order](const StateTreeNode &a, const StateTreeNode &b){
+            return std::find(order.begin(), order.end(), a.placement) < std::find(order.begin(), order.end(), b.placement);
+        });
+    }
+
+    search_depth = continuation.depth;
+    continuation.stopped = false;
+    if(root.childs.empty() || search_depth > max_search_depth(limits)){
+        continuation.finished = true;
+    }
+    else if(!search_root(continuation.result, continuation.lines)){
+        continuation.finished = true;
+        continuation.stopped = true;
+        continuation.lines = root_lines;
+    }
+    else{
+        continuation.lines.clear();
+        continuation.depth++;
+        continuation.root_order.clear();
+        for(auto &child:root.childs){
+            continuation.root_order.push_back(child.placement);
+        }
+        continuation.finished = continuation.depth > max_search_depth(limits);
+    }
+    continuation.killers = killers;
+    continuation.result.nodes += nodes;
+    continuation.result.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+}
+
+float DecisionMaker::root_alpha() const{
+    //with multi pv the root only cuts moves worse than the multi_pv-th best one
+    if(root_lines.size() < (size_t)multi_pv){
+        return -std::numeric_limits<float>::max();
+    }
+    std::vector<float> values;
+    for(auto &line:root_lines){
+        values.push_back(line.value);
+    }
+    std::nth_element(values.begin(), values.begin() + (multi_pv - 1), values.end(), std::greater<float>());
+    return values[multi_pv - 1];
+}
+
+float DecisionMaker::evaluate_board(){
+    if(trace){
+        uint64_t begin = trace->elapsed();
+        float value = use_network ? network.evaluate(player) : evaluator.evaluate(board.board);
+        trace->record(TRACE_EVAL, 0, 0, Point(-1, -1), 0, 0, value, begin, (uint32_t)(trace->elapsed() - begin));
+        return value;
+    }
+    if(use_network){
+        return network.evaluate(player);
+    }
+    return evaluator.evaluate(board.board);
+}
+
+float DecisionMaker::measure_score_scale() const{
+    //how much a live three in the middle of an empty board is worth to the network against the evaluator
+    std::vector<std::vector<int>> empty(SIZE, std::vector<int>(SIZE, 0)), three = empty;
+    three[SIZE/2][SIZE/2 - 1] = three[SIZE/2][SIZE/2] = three[SIZE/2][SIZE/2 + 1] = 1;
+    Evaluator string_evaluator = evaluator;
+    string_evaluator.set_player(1);
+    PatternNetwork scale_network = network;
+    scale_network.refresh(empty);
+    float network_empty = scale_network.evaluate(1);
+    scale_network.refresh(three);
+    float network_gain = scale_network.evaluate(1) - network_empty;
+    float evaluator_gain = string_evaluator.evaluate(three) - string_evaluator.evaluate(empty);
+    if(network_gain <= 0 || evaluator_gain <= 0) return 1.0f;
+    return network_gain/evaluator_gain;
+}
+
+unsigned long long DecisionMaker::cache_key(int curr_player, int &symmetry) const{
+    //mirror images of a board share their entry, symmetry turns moves of this board into moves of the stored one
+    //values are for the root player, from the evaluator in use and the beam width (a beam only gives bounds of the moves it searched),
+    //the same pieces are different entries for each
+    unsigned long long key = board.get_canonical_hash(symmetry);
+    if(curr_player == 2) key ^= 0x9e3779b97f4a7c15ULL;
+    if(player == 2) key ^= 0xc2b2ae3d27d4eb4fULL;
+    if(use_network) key ^= 0x165667b19e3779f9ULL;
+    if(beam_width > 0) key ^= 0xd6e8feb86659fd93ULL*beam_width;
+    return key;
+}
+
+bool DecisionMaker::out_of_budget(){
+    if(node_limit > 0 && nodes >= node_limit){
+        return true;
+    }
+    //reading the clock is slow, only do it every 256 nodes unless the deadline is in microseconds
+    if(stop_flag && (nodes & 255) == 0 && stop_flag->load(std::memory_order_relaxed)){
+        return true;
+    }
+    if(time_limit > 0 && (exact_deadline || (nodes & 255) == 0)){
+        auto used = std::chrono::steady_clock::now() - start_time;
+        return std::chrono::duration_cast<std::chrono::microseconds>(used).count() >= time_limit;
+    }
+    return false;
+}
+
+std::vector<long long> DecisionMaker::perft(int depth, bool &restored){
+    //count every move sequence of each length the move generator gives, counts[0] is the position itself
+    possible_step_set.clear();
+    get_all_possible_steps();
+    std::set<Point> initial_steps = possible_step_set;
+    std::vector<long long> counts(depth + 1, 0);
+    counts[0] = 1;
+    perft_node(1, depth, player, counts);
+    //place_piece and remove_piece must leave the possible step set as it was
+    restored = (possible_step_set == initial_steps);
+    return counts;
+}
+
+void DecisionMaker::perft_node(int ply, int depth, int curr_player, std::vector<long long> &counts){
+    counts[ply] += possible_step_set.size();
+    if(ply == depth) return;
+    int next_player = (curr_player == 1) ? 2:1;
+    //the set changes while the moves are placed, go through a copy
+    std::vector<Point> steps(possible_step_set.begin(), possible_step_set.end());
+    for(auto &step:steps){
+        std::vector<Point> added;
+        place_piece(step, curr_player, added);
+        perft_node(ply+1, depth, next_player, counts);
+        remove_piece(step, added);
+    }
+}
+
+std::vector<long long> DecisionMaker::perft_tree(int depth, bool &consistent){
+    //count the childs create_tree gives at every ply, the moves the search really looks at
+    possible_step_set.clear();
+    get_all_possible_steps();
+    std::set<Point> initial_steps = possible_step_set;
+    std::vector<long long> counts(depth + 1, 0);
+    counts[0] = 1;
+    consistent = true;
+    perft_tree_node(1, depth, player, counts, consistent);
+    consistent = consistent && possible_step_set == initial_steps;
+    return counts;
+}
+
+void DecisionMaker::perft_tree_node(int ply, int depth, int curr_player, std::vector<long long> &counts, bool &consistent){
+    StateTreeNode node(curr_player);
+    create_tree(node, curr_player);
+    counts[ply] += node.childs.size();
+    //the filters only drop moves, a move they keep must come from the generator and at least one must be kept
+    for(auto &child:node.childs){
+        if(!possible_step_set.count(child.placement) || !board.is_valid(child.placement)) consistent = false;
+    }
+    if(node.childs.empty() && !possible_step_set.empty()) consistent = false;
+    if(ply == depth) return;
+    int next_player = (curr_player == 1) ? 2:1;
+    for(auto &child:node.childs){
+        //the search doesn't go on after a five
+        if(child.attack == WIN5) continue;
+        std::vector<Point> added;
+        place_piece(child.placement, curr_player, added);
+        perft_tree_node(ply+1, depth, next_player, counts, consistent);
+        remove_piece(child.placement, added);
+    }
+}
+
+void DecisionMaker::print_possible_steps() const{
+    std::cout << "----possble next steps----" << std::endl;
+    for(auto step : possible_step_set){
+        std::cout << step << ' ';
+    }
+    std::cout << std::endl;
+}
+
+void DecisionMaker::print_tree(const StateTreeNode &node) const{
+    std::cout << "New Level" << std::endl;
+    for(auto &child:node.childs){
+        std::cout << child.placement << ':' << child.value << ' ';
+    }
+    std::cout << std::endl;
+    for(auto &child:node.childs){
+        print_tree(child);
+    }
+}
+
+void DecisionMaker::create_tree(StateTreeNode &node, int curr_player){
+    //only creates the childs of node, deeper levels are created while searching
+    int next_player = (curr_player == 1) ? 2:1;
+    
+    //create childs
+    for(auto possible_step : possible_step_set){
+        StateTreeNode child(possible_step, next_player, &node);
+        child.attack = threat_detector.move_situation(board.board, possible_step.x, possible_step.y, curr_player);
+        child.defence = threat_detector.move_situation(board.board, possible_step.x, possible_step.y, next_player);
+        child.score = threat_detector.situation_score(child.attack) + threat_detector.situation_score(child.defence);
+        node.childs.push_back(child);
+    }
+    filter_forced_moves(node);
+    remove_symmetric_moves(node);
+
+    //search the strongest moves first so the later ones can be cut or reduced
+    std::stable_sort(node.childs.begin(), node.childs.end(), [](const StateTreeNode &a, const StateTreeNode &b){
+        return a.score > b.score;
+    });
+}
+
+void DecisionMaker::filter_forced_moves(StateTreeNode &node){
+    //when someone is about to win only a few moves make sense, drop the others
+    int best_attack = NO_SITUATION;
+    int best_defence = NO_SITUATION;
+    for(auto &child:node.childs){
+        best_attack = std::min(best_attack, child.attack);
+        best_defence = std::min(best_defence, child.defence);
+    }
+
+    std::function<bool(const StateTreeNode &)> is_forced;
+    if(best_attack == WIN5){
+        //just win
+        is_forced = [](const StateTreeNode &child){ return child.attack == WIN5; };
+    }
+    else if(best_defence == WIN5){
+        //the other one has a four, block the five
+        is_forced = [](const StateTreeNode &child){ return child.defence == WIN5; };
+    }
+    else if(best_defence == LIVE4){
+        //the other one has a live three, block it where it can become a four
+        //or make our own four so they have to answer it first
+        is_forced = [](const StateTreeNode &child){ return child.defence <= OPEN4 || child.attack <= OPEN4; };
+    }
+    else{
+        return;
+    }
+    node.childs.erase(std::remove_if(node.childs.begin(), node.childs.end(), [&](const StateTreeNode &child){
+        return !is_forced(child);
+    }), node.childs.end());
+}
+
+void DecisionMaker::remove_symmetric_moves(StateTreeNode &node){
+    //on a symmetric board (mostly the first moves) a move and its mirror images lead to the same game
+    //only the first of every such class is kept
+    std::vector<int> symmetries = board.symmetries();
+    if(symmetries.empty()) return;
+    std::set<Point> kept;
+    node.childs.erase(std::remove_if(node.childs.begin(), node.childs.end(), [&](const StateTreeNode &child){
+        for(int symmetry:symmetries){
+            if(kept.count(board.transform(child.placement, symmetry))) return true;
+        }
+        kept.insert(child.placement);
+        return false;
+    }), node.childs.end());
+}
+
+void DecisionMaker::place_piece(Point &point, int curr_player, std::vector<Point> &added){
+    //update board
+    board.add_piece(point, curr_player);
+    
+    //update possible step set
+    for(auto delta_distanse:directions){
+        Point possible_point = point + delta_distanse;
+        if(possible_step_set.find(possible_point) == possible_step_set.cend() && board.is_valid(possible_point)){
+            possible_step_set.insert(possible_point);
+            //record the changes
+            added.push_back(possible_point);
+        }
+    }
+    possible_step_set.erase(point);
+}
+
+void DecisionMaker::remove_piece(Point &point, std::vector<Point> &added){
+    //reset board
+    board.delete_piece(point);
+
+    //reset possible step set
+    for(auto added_point:added){
+        possible_step_set.erase(added_point);
+    }
+    possible_step_set.insert(point);
+}
+
+void DecisionMaker::get_all_possible_steps(){
+    //all the spaces 2 away from a existing chess piece is possble next move
+    bool found = false;
+    for(int x = 0; x < SIZE; x++){
+        for(int y = 0; y < SIZE; y++){
+            if(!board.is_empty(x, y)){
+                found = true;
+                Point curr_point = Point(x, y);
+                for(auto delta_distanse:directions){
+                    Point possible_point = curr_point + delta_distanse;
+                    if(board.is_valid(possible_point)){
+                        possible_step_set.insert(possible_point);
+                    }
+                }
+            }
+        }
+    }
+
+    //if the chess board is empty
+    if(!found){
+        possible_step_set.insert(Point(7, 7));
+    }
+}
+
+float DecisionMaker::alpha_beta_pruning(StateTreeNode &node, int depth, int ply, float alpha, float beta, bool is_player){
+    //every node goes through here so the trace sees it enter and exit
+    if(!trace){
+        return alpha_beta_search(node, depth, ply, alpha, beta, is_player);
+    }
+    trace->record(TRACE_ENTER, ply, search_depth - depth, node.placement, alpha, beta, 0, trace->elapsed());
+    float value = alpha_beta_search(node, depth, ply, alpha, beta, is_player);
+    trace->record(TRACE_EXIT, ply, search_depth - depth, node.placement, alpha, beta, value, trace->elapsed());
+    return value;
+}
+
+float DecisionMaker::alpha_beta_search(StateTreeNode &node, int depth, int ply, float alpha, float beta, bool is_player){
+    nodes++;
+    pv_table[ply].clear();
+    if(stopped || out_of_budget()){
+        //the value is not used after stopping
+        stopped = true;
+        return 0;
+    }
+    if(depth >= search_depth){
+        node.value = evaluate_board();
+        return node.value;
+    }
+    int curr_player = is_player ? player : enemy;
+    int remaining = search_depth - depth;
+    float alpha_start = alpha;
+    float beta_start = beta;
+    unsigned long long key = 0;
+    int symmetry = 0;
+    Point cached_move(-1, -1);
+    if(cache){
+        key = cache_key(curr_player, symmetry);
+        CacheEntry entry;
+        if(cache->probe(key, entry)){
+            if(entry.x >= 0){
+                cached_move = board.inverse_transform(Point(entry.x, entry.y), symmetry);
+            }
+            //the root always searches so every root move gets a value
+            if(ply > 0 && entry.depth >= remaining &&
+               (entry.bound == BOUND_EXACT || (entry.bound == BOUND_LOWER && entry.value >= beta) || (entry.bound == BOUND_UPPER && entry.value <= alpha))){
+                node.value = entry.value;
+                return node.value;
+            }
+        }
+    }
+    if(node.childs.empty()){
+        create_tree(node, curr_player);
+        //the best move of an earlier search goes first
+        auto cached_child = std::find_if(node.childs.begin(), node.childs.end(), [&](const StateTreeNode &child){
+            return child.placement == cached_move;
+        });
+        if(cached_child != node.childs.end()){
+            std::rotate(node.childs.begin(), cached_child, cached_child + 1);
+        }
+        //then the threats, then the moves that cut off their siblings
+        auto quiet = std::find_if(node.childs.begin() + (cached_child != node.childs.end()), node.childs.end(), [&](const StateTreeNode &child){
+            return !threat_detector.is_tactical(child.attack) && !threat_detector.is_tactical(child.defence);
+        });
+        for(auto killer = killers[ply].rbegin(); killer != killers[ply].rend(); killer++){
+            auto killer_child = std::find_if(quiet, node.childs.end(), [&](const StateTreeNode &child){
+                return child.placement == *killer;
+            });
+            if(killer_child != node.childs.end()){
+                std::rotate(quiet, killer_child, killer_child + 1);
+            }
+        }
+        //beam search, the rest of the moves are never looked at
+        if(beam_width > 0 && node.childs.size() > beam_width){
+            node.childs.resize(beam_width);
+        }
+    }
+
+    //for players turn the bigger the points the better, for enemies turn the smaller
+    float value = is_player ? -std::numeric_limits<float>::max() : std::numeric_limits<float>::max();
+    float static_value = 0;
+    bool has_static_value = false;
+    bool frontier = (depth + 1 >= search_depth);
+    int move_count = 0;
+    for(auto &child:node.childs){
+        move_count++;
+        bool tactical = threat_detector.is_tactical(child.attack) || threat_detector.is_tactical(child.defence);
+
+        //late move pruning
+        //two plies above the leaves the quiet moves this far down the order are not worth a search
+        if(ply > 0 && remaining <= 3 && !tactical && move_count > LMP_MOVES*(remaining - 1)){
+            child.value = is_player ? -std::numeric_limits<float>::max() : std::numeric_limits<float>::max();
+            continue;
+        }
+
+        //futility pruning
+        //at the last ply a quiet move can only change the board by about its own score
+        //if even that can't reach the bound the move is not worth evaluating
+        if(frontier && !tactical && move_count > 1){
+            if(!has_static_value){
+                static_value = evaluate_board();
+                has_static_value = true;
+            }
+            float margin = (child.score + FUTILITY_MARGIN)*score_scale;
+            if((is_player && static_value + margin <= alpha) ||
+               (!is_player && static_value - margin >= beta)){
+                child.value = is_player ? -std::numeric_limits<float>::max() : std::numeric_limits<float>::max();
+                continue;
+            }
+        }
+
+        std::vector<Point> added;
+        place_piece(child.placement, curr_player, added);
+        float child_value = 0;
+        if(child.attack == WIN5){
+            //game is over, no need to look deeper
+            //a fixed score whatever the evaluator, a five is worth more than any position and the sooner the better
+            child_value = is_player ? WIN_SCORE - ply : -(WIN_SCORE - ply);
+            child.value = child_value;
+            pv_table[ply+1].clear();
+        }
+        else{
+            //late move reductions
+            //quiet moves late in the order are searched shallower first
+            //and only searched again with full depth if they turn out better than alpha(beta)
+            bool full_search = true;
+            int reduction = LMR_REDUCTION + (move_count > LMR_DEEP_MOVES ? 1 : 0);
+            if(!tactical && move_count > LMR_FULL_MOVES && remaining > reduction + 1){
+                child_value = alpha_beta_pruning(child, depth+1+reduction, ply+1, alpha, beta, !is_player);
+                full_search = is_player ? child_value > alpha : child_value < beta;
+            }
+            if(full_search && !stopped){
+                child_value = alpha_beta_pruning(child, depth+1, ply+1, alpha, beta, !is_player);
+            }
+        }
+        remove_piece(child.placement, added);
+        if(depth > 1){
+            //only the values of the root childs are needed after searching
+            std::vector<StateTreeNode>().swap(child.childs);
+        }
+        if(stopped) return 0;
+
+        if(ply == 0){
+            PVLine line;
+            line.move = child.placement;
+            line.value = child_value;
+            line.pv.assign(1, child.placement);
+            line.pv.insert(line.pv.end(), pv_table[ply+1].begin(), pv_table[ply+1].end());
+            root_lines.push_back(line);
+        }
+        if(is_player ? child_value > value : child_value < value){
+            //remember the line that gives the new best value
+            pv_table[ply].assign(1, child.placement);
+            pv_table[ply].insert(pv_table[ply].end(), pv_table[ply+1].begin(), pv_table[ply+1].end());
+        }
+        if(is_player){
+            value = std::max(value, child_value);
+            alpha = (ply == 0 && multi_pv > 1) ? root_alpha() : std::max(alpha, value);
+            if(alpha >= beta){
+                if(trace) trace->record(TRACE_CUTOFF, ply, search_depth - depth, child.placement, alpha, beta, child_value, trace->elapsed());
+                add_killer(ply, child, tactical);
+                //beta will have the memory of all the child form the node parents(siblings)
+                //if alpha is bigger means that the player will have better score at this path
+                //so the enemy won't choose this path
+                break;
+            }
+        }
+        else{
+            value = std::min(value, child_value);
+            beta = std::min(beta, value);
+            if(beta <= alpha){
+                if(trace) trace->record(TRACE_CUTOFF, ply, search_depth - depth, child.placement, alpha, beta, child_value, trace->elapsed());
+                add_killer(ply, child, tactical);
+                //alpha will have the memory of the nodes siblings
+                //if beta is small means the player won't want this path
+                //cause the enemy can go to a better board, compared to the other sibling paths in the tree that is visited before
+                break;
+            }
+        }
+    }
+    if(move_count == 0){
+        //board is full
+        value = evaluate_board();
+    }
+    node.value = value;
+    if(cache && ply > 0){
+        //the root may only have searched some of its moves
+        int bound = (value <= alpha_start) ? BOUND_UPPER : (value >= beta_start) ? BOUND_LOWER : BOUND_EXACT;
+        Point best = pv_table[ply].empty() ? Point(-1, -1) : board.transform(pv_table[ply].front(), symmetry);
+        cache->store(key, value, remaining, bound, best.x, best.y);
+    }
+    return value;
+}
+
+void DecisionMaker::add_killer(int ply, const StateTreeNode &child, bool tactical){
+    //threats are searched first anyway, only quiet moves are remembered
+    if(tactical) return;
+    std::vector<Point> &ply_killers = killers[ply];
+    ply_killers.erase(std::remove(ply_killers.begin(), ply_killers.end(), child.placement), ply_killers.end());
+    ply_killers.insert(ply_killers.begin(), child.placement);
+    if(ply_killers.size() > 2) ply_killers.pop_back();
+}
+
+void DecisionMaker::init_directions(){
+    /*
+    directions.push_back(Point(-1, 1));
+    directions.push_back(Point(0, 1));
+    directions.push_back(Point(1, 1));
+
+
+    directions.push_back(Point(-1, 0));
+    directions.push_back(Point(1, 0));
+
+
+    directions.push_back(Point(-1, -1));
+    directions.push_back(Point(0, -1));
+    directions.push_back(Point(1, -1));
+    */
+    
+    directions.push_back(Point(-2, 2));
+    directions.push_back(Point(-1, 2));
+    directions.push_back(Point(0, 2));
+    directions.push_back(Point(1, 2));
+    directions.push_back(Point(2, 2));
+    
+    directions.push_back(Point(-2, 1));
+    directions.push_back(Point(-1, 1));
+    directions.push_back(Point(0, 1));
+    directions.push_back(Point(1, 1));
+    directions.push_back(Point(2, 1));
+
+    directions.push_back(Point(-2, 0));
+    directions.push_back(Point(-1, 0));
+    directions.push_back(Point(1, 0));
+    directions.push_back(Point(2, 0));
+
+    directions.push_back(Point(-2, -1));
+    directions.push_back(Point(-1, -1));
+    directions.push_back(Point(0, -1));
+    directions.push_back(Point(1, -1));
+    directions.push_back(Point(2, -1));
+
+    directions.push_back(Point(-2, -2));
+    directions.push_back(Point(-1, -2));
+    directions.push_back(Point(0, -2));
+    directions.push_back(Point(1, -2));
+    directions.push_back(Point(2, -2));
+    
+}
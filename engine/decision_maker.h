@@ -0,0 +1,137 @@
+#ifndef GOBANG_DECISION_MAKER_H
+#define GOBANG_DECISION_MAKER_H
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <set>
+#include <vector>
+
+#include "config.h"
+#include "point.h"
+#include "state_tree.h"
+#include "chess_board.h"
+#include "evaluator.h"
+#include "threat_detector.h"
+#include "pattern_network.h"
+#include "proof_solver.h"
+#include "search_cache.h"
+#include "search_trace.h"
+
+struct SearchLimits{
+    //0 means no limit
+    int depth = 0; //plies, at most MAX_DEPTH
+    long long nodes = 0;
+    int time = 0; //ms
+    long long time_us = 0; //hard deadline in microseconds, the clock is read at every node
+    int threads = 1;
+    int multi_pv = 1; //how many of the best root moves get their value and line
+    long long solver_nodes = 0; //proof search before searching, a proven win is played at once
+    int beam_width = 0; //only search the beam_width moves with the best threat score at every ply, 0 searches all
+    std::vector<Point> root_moves; //only search these root moves if not empty
+    const std::atomic<bool> *stop = nullptr; //the search stops once it is set, looked at with the clock
+};
+
+struct PVLine{
+    Point move;
+    float value;
+    std::vector<Point> pv; //move and the replies expected after it
+};
+
+struct SearchResult{
+    Point best_move;
+    float value = 0;
+    int depth = 0; //plies of the deepest finished search
+    long long nodes = 0;
+    double seconds = 0;
+    std::vector<Point> pv; //best_move and the replies expected after it
+    std::vector<PVLine> lines; //the best root moves, best first, at most multi_pv of them
+    int proof = PROOF_UNKNOWN; //what the proof search found out about the position
+};
+
+struct SearchContinuation{
+    //where an iterative deepening search goes on after search_iteration
+    int depth = 2; //search_depth of the next iteration
+    bool finished = false;
+    bool stopped = false; //the last iteration ran out of its limits before the depth was done
+    std::vector<Point> root_order; //root moves best first after the last iteration
+    std::vector<PVLine> lines; //root moves the stopped depth finished, they are not searched again when it goes on
+    std::vector<std::vector<Point>> killers; //of the last iteration, finished or not
+    SearchResult result; //of the last finished iteration, nodes and seconds of all of them
+};
+
+class DecisionMaker{
+    //search one position at a time, everything built in the constructor is kept between positions
+    public:
+        DecisionMaker();
+        void set_position(int player, const ChessBoard &board);
+        void set_cache(SearchCache *cache);
+        void set_trace(SearchTrace *trace);
+        unsigned long long evaluation_hash() const;
+        SearchResult search(const SearchLimits &limits, std::function<void(const SearchResult &)> on_iteration = nullptr);
+        void search_iteration(const SearchLimits &limits, SearchContinuation &continuation);
+        std::vector<Point> root_moves();
+        std::vector<long long> perft(int depth, bool &restored);
+        std::vector<long long> perft_tree(int depth, bool &consistent);
+        void print_possible_steps() const;
+        void print_tree(const StateTreeNode &node) const;
+    private:
+        void create_root();
+        void start_search(const SearchLimits &limits);
+        SearchResult empty_result() const;
+        int max_search_depth(const SearchLimits &limits) const;
+        bool search_root(SearchResult &result, const std::vector<PVLine> &finished_lines);
+        void create_tree(StateTreeNode &node, int curr_player);
+        void filter_forced_moves(StateTreeNode &node);
+        void remove_symmetric_moves(StateTreeNode &node);
+        void perft_node(int ply, int depth, int curr_player, std::vector<long long> &counts);
+        void perft_tree_node(int ply, int depth, int curr_player, std::vector<long long> &counts, bool &consistent);
+        void place_piece(Point &point, int curr_player, std::vector<Point> &added);
+        void remove_piece(Point &point, std::vector<Point> &added);
+        void get_all_possible_steps();
+        void init_directions();
+        bool out_of_budget();
+        float evaluate_board();
+        float measure_score_scale() const;
+        float root_alpha() const;
+        void add_killer(int ply, const StateTreeNode &child, bool tactical);
+        unsigned long long cache_key(int curr_player, int &symmetry) const;
+        float alpha_beta_pruning(StateTreeNode &node, int depth, int ply, float alpha, float beta, bool is_player);
+        float alpha_beta_search(StateTreeNode &node, int depth, int ply, float alpha, float beta, bool is_player);
+        
+        //basic information
+        int player;
+        int enemy;
+        const int DEPTH = _DEPTH; //the deepest search has DEPTH-1 plies when nothing else ends the deepening
+        const int SIZE = 15;
+        //chess board
+        ChessBoard board;
+        //for tree
+        StateTreeNode root;
+        std::vector<Point> directions;
+        std::set<Point> possible_step_set;
+        Evaluator evaluator;
+        ThreatDetector threat_detector;
+        PatternNetwork network;
+        bool use_network;
+        float score_scale; //network units for one evaluator unit, the threat scores and futility margin are in evaluator units
+        //search limits, 0 means no limit
+        int search_depth;
+        long long nodes;
+        long long node_limit;
+        long long time_limit; //us
+        bool exact_deadline; //read the clock at every node instead of every 256
+        const std::atomic<bool> *stop_flag;
+        size_t beam_width;
+        std::chrono::steady_clock::time_point start_time;
+        bool stopped;
+        std::vector<std::vector<Point>> pv_table; //best line found below each ply, grows with search_depth
+        std::vector<std::vector<Point>> killers; //the last quiet moves that caused a cutoff at each ply, tried right after the threats
+        SearchCache *cache = nullptr; //shared with the other threads and processes, nullptr if off
+        SearchTrace *trace = nullptr; //nullptr if off
+        //multi pv
+        int multi_pv;
+        std::vector<PVLine> root_lines; //every searched root move of the current iteration
+};
+
+#endif
@@ -0,0 +1,211 @@
+#include "engine.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <thread>
+
+Engine::Engine(): player{1}{
+    board = ChessBoard(std::vector<std::vector<int>>(SIZE, std::vector<int>(SIZE, 0)));
+    workers.push_back(std::unique_ptr<DecisionMaker>(new DecisionMaker()));
+    workers.back()->set_cache(SearchCache::shared(workers.back()->evaluation_hash()));
+    const char *path = std::getenv(TRACE_ENV);
+    if(path != nullptr){
+        trace_path = path;
+    }
+}
+
+void Engine::set_position(int player, const std::vector<std::vector<int>> &board){
+    set_position(player, ChessBoard(board));
+}
+
+void Engine::set_position(int player, const ChessBoard &board){
+    this->player = player;
+    this->board = board;
+}
+
+bool Engine::set_position(std::istream &state){
+    //player then the board, like the state file
+    int input_player;
+    ChessBoard input_board;
+    StateReader reader(state, SIZE);
+    if(!reader.next(input_player, input_board)) return false;
+    set_position(input_player, input_board);
+    return true;
+}
+
+SearchResult Engine::search(const SearchLimits &limits, std::function<void(const SearchResult &)> on_iteration){
+    if(limits.solver_nodes <= 0){
+        return search_threads(limits, on_iteration);
+    }
+
+    //a quarter of the time may go to the proof search, none if that is less than a millisecond
+    int solver_time = limits.time/4;
+    if(limits.time_us > 0){
+        solver_time = (solver_time > 0) ? std::min<long long>(solver_time, limits.time_us/4000) : limits.time_us/4000;
+        if(solver_time == 0){
+            return search_threads(limits, on_iteration);
+        }
+    }
+    auto start_time = std::chrono::steady_clock::now();
+    if(!solver){
+        solver.reset(new ProofSolver());
+    }
+    ProofResult proof = solver->solve(player, board, limits.solver_nodes, solver_time);
+    if(proof.result == PROOF_WIN){
+        //no need to search a won position
+        SearchResult result;
+        result.best_move = proof.move;
+        result.value = std::numeric_limits<float>::max();
+        result.depth = 0;
+        result.nodes = proof.nodes;
+        result.seconds = proof.seconds;
+        result.pv.assign(1, proof.move);
+        PVLine line;
+        line.move = proof.move;
+        line.value = result.value;
+        line.pv = result.pv;
+        result.lines.assign(1, line);
+        result.proof = PROOF_WIN;
+        if(on_iteration) on_iteration(result);
+        return result;
+    }
+
+    //making the solver the first time counts too
+    SearchLimits search_limits = limits;
+    auto used = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time).count();
+    if(limits.time > 0){
+        search_limits.time = std::max(1, limits.time - (int)(used/1000));
+    }
+    if(limits.time_us > 0){
+        search_limits.time_us = std::max(1LL, limits.time_us - (long long)used);
+    }
+    SearchResult result = search_threads(search_limits, on_iteration);
+    result.nodes += proof.nodes;
+    result.seconds += proof.seconds;
+    result.proof = proof.result;
+    return result;
+}
+
+SearchResult Engine::search_threads(const SearchLimits &limits, std::function<void(const SearchResult &)> on_iteration){
+    auto start_time = std::chrono::steady_clock::now();
+    int thread_number = std::max(1, limits.threads);
+    while(workers.size() < (size_t)thread_number){
+        workers.push_back(std::unique_ptr<DecisionMaker>(new DecisionMaker()));
+        workers.back()->set_cache(SearchCache::shared(workers.back()->evaluation_hash()));
+    }
+    for(int i = 0; i < thread_number; i++){
+        workers[i]->set_position(player, board);
+    }
+    if(!trace_path.empty()){
+        while(traces.size() < (size_t)thread_number){
+            traces.push_back(std::unique_ptr<SearchTrace>(new SearchTrace(traces.size(), TRACE_EVENTS)));
+        }
+        for(int i = 0; i < thread_number; i++){
+            traces[i]->clear(start_time);
+            workers[i]->set_trace(traces[i].get());
+        }
+    }
+
+    //a microsecond deadline also counts the time spent getting ready
+    SearchLimits worker_limits = limits;
+    if(limits.time_us > 0){
+        auto used = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time).count();
+        worker_limits.time_us = std::max(1LL, limits.time_us - (long long)used);
+    }
+    if(thread_number <= 1){
+        SearchResult result = workers[0]->search(worker_limits, on_iteration);
+        save_traces(1);
+        return result;
+    }
+
+    //the root moves are split between the threads, every thread searches its own share
+    std::vector<Point> moves = limits.root_moves.empty() ? workers[0]->root_moves() : limits.root_moves;
+    if(limits.beam_width > 0 && moves.size() > (size_t)limits.beam_width){
+        //only the beam is split between the threads
+        moves.resize(limits.beam_width);
+    }
+    thread_number = std::min<int>(thread_number, moves.size());
+    if(thread_number <= 1){
+        SearchResult result = workers[0]->search(worker_limits, on_iteration);
+        save_traces(1);
+        return result;
+    }
+
+    std::vector<SearchLimits> thread_limits(thread_number, worker_limits);
+    for(int i = 0; i < thread_number; i++){
+        thread_limits[i].root_moves.clear();
+        thread_limits[i].nodes = (limits.nodes > 0) ? std::max(1LL, limits.nodes/thread_number) : 0;
+    }
+    for(size_t i = 0; i < moves.size(); i++){
+        //moves are ordered best first, deal them out so every thread gets good and bad ones
+        thread_limits[i % thread_number].root_moves.push_back(moves[i]);
+    }
+
+    finished.clear();
+    SearchResult best;
+    bool has_best = false;
+    std::vector<SearchResult> last_results(thread_number);
+    std::vector<std::thread> threads;
+    for(int i = 0; i < thread_number; i++){
+        threads.push_back(std::thread([&, i](){
+            last_results[i] = workers[i]->search(thread_limits[i], [&](const SearchResult &result){
+                std::lock_guard<std::mutex> lock(mutex);
+                std::vector<SearchResult> &depth_results = finished[result.depth];
+                depth_results.push_back(result);
+                if(depth_results.size() == (size_t)thread_number){
+                    best = merge(depth_results, limits.multi_pv);
+                    best.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+                    has_best = true;
+                    if(on_iteration) on_iteration(best);
+                }
+            });
+        }));
+    }
+    for(auto &thread:threads){
+        thread.join();
+    }
+
+    if(!has_best){
+        //not even the first depth finished on every thread
+        best = merge(last_results, limits.multi_pv);
+    }
+    best.nodes = 0;
+    for(auto &result:last_results){
+        best.nodes += result.nodes;
+    }
+    best.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    save_traces(thread_number);
+    return best;
+}
+
+void Engine::save_traces(int thread_number) const{
+    //the trace of the last search replaces the one before
+    if(!trace_path.empty() && !save_trace(trace_path, traces, thread_number)){
+        std::cerr << "can't write the search trace " << trace_path << std::endl;
+    }
+}
+
+SearchResult Engine::merge(const std::vector<SearchResult> &results, int multi_pv) const{
+    //the best move is the best of the threads, the lines of all threads are sorted together
+    SearchResult merged = results.front();
+    merged.nodes = 0;
+    merged.lines.clear();
+    for(auto &result:results){
+        if(result.depth > merged.depth || (result.depth == merged.depth && result.value > merged.value)){
+            merged.best_move = result.best_move;
+            merged.value = result.value;
+            merged.depth = result.depth;
+            merged.pv = result.pv;
+        }
+        merged.nodes += result.nodes;
+        merged.lines.insert(merged.lines.end(), result.lines.begin(), result.lines.end());
+    }
+    std::stable_sort(merged.lines.begin(), merged.lines.end(), [](const PVLine &a, const PVLine &b){
+        return a.value > b.value;
+    });
+    merged.lines.resize(std::min<size_t>(std::max(1, multi_pv), merged.lines.size()));
+    return merged;
+}
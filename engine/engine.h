@@ -0,0 +1,48 @@
+#ifndef GOBANG_ENGINE_H
+#define GOBANG_ENGINE_H
+
+#include <functional>
+#include <istream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "point.h"
+#include "chess_board.h"
+#include "decision_maker.h"
+#include "proof_solver.h"
+#include "search_trace.h"
+
+class Engine{
+    //the library api: set a position, search it with limits, get the best moves and their lines back
+    //Engine engine;
+    //engine.set_position(1, board);
+    //SearchLimits limits; limits.time = 1000; limits.multi_pv = 3;
+    //SearchResult result = engine.search(limits, [](const SearchResult &r){ ... every finished depth ... });
+    public:
+        Engine();
+        void set_position(int player, const std::vector<std::vector<int>> &board);
+        void set_position(int player, const ChessBoard &board);
+        bool set_position(std::istream &state);
+        SearchResult search(const SearchLimits &limits, std::function<void(const SearchResult &)> on_iteration = nullptr);
+    private:
+        SearchResult search_threads(const SearchLimits &limits, std::function<void(const SearchResult &)> on_iteration);
+        SearchResult merge(const std::vector<SearchResult> &results, int multi_pv) const;
+        void save_traces(int thread_number) const;
+        const int SIZE = 15;
+        int player;
+        ChessBoard board;
+        //one for each thread, kept between searches
+        std::vector<std::unique_ptr<DecisionMaker>> workers;
+        std::unique_ptr<ProofSolver> solver; //only made when a search asks for a proof search
+        //every search is traced and written to trace_path if the TRACE_ENV environment variable is set
+        std::string trace_path;
+        std::vector<std::unique_ptr<SearchTrace>> traces;
+        //finished depths of every thread, a depth is reported when all threads have it
+        std::mutex mutex;
+        std::map<int, std::vector<SearchResult>> finished;
+};
+
+#endif
@@ -0,0 +1,406 @@
+#include "evaluator.h"
+
+#include <fstream>
+#include <iostream>
+
+PlayerScore::PlayerScore(){
+    situation_occurence = std::vector<int>(SITUAION_NUMBER, 0);
+};
+
+
+Evaluator::Evaluator(int size, int player): SIZE{size}, player{player}{
+    situation_scores[WIN5] = 1000000.0;
+    situation_scores[LIVE4] = 2000.0;
+    situation_scores[OPEN4] = 1400.0;
+    situation_scores[LIVE3] = 1000.0;
+    situation_scores[OPEN3] = 400.0;
+    situation_scores[SELF2] = 200.0;
+    situation_scores[ENEMY2] = 50.0;
+
+    // OOPOO
+    win5_set.insert("OOOOO");
+    
+    // .OPOO.
+    live4_set.insert(".OOOO.");
+
+    // XOPOO
+    open4_set.insert("XOOOO.");
+    open4_set.insert(".OOOOX");
+
+    // O.POO
+    open4_set.insert("O.OOO.");
+    open4_set.insert("O.OOOX");
+    // OOP.O
+    open4_set.insert("XOOO.O");
+    open4_set.insert(".OOO.O");
+
+    // OP.OO
+    open4_set.insert(".OO.OO");
+    open4_set.insert("XOO.OO");
+
+    // OPO
+    live3_set.insert("..OOO..");
+    live3_set.insert("X.OOO..");
+    live3_set.insert("..OOO.X");
+    live3_set.insert("X.OOO.X");
+
+    // O.PO
+    live3_set.insert(".O.OO..");
+    live3_set.insert(".O.OO.X");
+    // OP.O
+    live3_set.insert("..OO.O.");
+    live3_set.insert("X.OO.O.");
+
+    // XOOP..
+    open3_set.insert("XOOO...");
+    open3_set.insert("XOOO..X");
+    // ..POOX
+    open3_set.insert("X..OOOX");
+    open3_set.insert("...OOOX");
+
+    // XOP.O.
+    open3_set.insert("XXOO.O.");
+    open3_set.insert(".XOO.O.");
+    // .O.POX
+    open3_set.insert(".O.OOXX");
+    open3_set.insert(".O.OOX.");
+    
+    // XO.POO.
+    open3_set.insert("XO.OO..");
+    open3_set.insert("XO.OO.X");
+    // .OP.OX
+    open3_set.insert("..OO.OX");
+    open3_set.insert("X.OO.OX");
+
+    // O..PO
+    open3_set.insert("O..OOXX");
+    open3_set.insert("O..OOX.");
+    open3_set.insert("O..OO.X");
+    open3_set.insert("O..OO..");
+    // OP..O
+    open3_set.insert("XXOO..O");
+    open3_set.insert("X.OO..O");
+    open3_set.insert(".XOO..O");
+    open3_set.insert("..OO..O");
+
+    // O.O.O
+    open3_set.insert(".O.O.O.");
+    open3_set.insert("XO.O.O.");
+    open3_set.insert(".O.O.OX");
+    open3_set.insert("XO.O.OX");
+
+    // X.OOO.X
+    open3_set.insert("X.OOO.X");
+};
+
+void Evaluator::set_player(int player){
+    this->player = player;
+}
+
+float Evaluator::evaluate(const std::vector<std::vector<int>> &board){
+    float player1_final_score = noise()%20;
+    float player2_final_score = noise()%20;
+    count_situations(board);
+
+    // caculate score
+    for(int i = 0; i < SITUAION_NUMBER; i++){
+        player1_final_score += (float)player1_score.situation_occurence[i] * situation_scores[i];
+        player2_final_score += (float)player2_score.situation_occurence[i] * situation_scores[i];
+    }
+
+    if(player == 1){
+        return player1_final_score - player2_final_score*enemy_score_multiplier;
+    }
+    else{
+        return player2_final_score - player1_final_score*enemy_score_multiplier;
+    }
+}
+
+void Evaluator::count_situations(const std::vector<std::vector<int>> &board){
+    //fill player1_score and player2_score
+    bool game_end = false;
+    player1_score = PlayerScore();
+    player2_score = PlayerScore();
+
+    // evaluate board
+    for(int x = 0; x < SIZE; x++){
+        for(int y = 0; y < SIZE; y++){
+            if(board[x][y] != 0){
+                if(evaluate_piece(x, y, board)){
+                    game_end = true;
+                    break;
+                }
+            }
+        }
+        if(game_end) break;
+    }
+}
+
+bool Evaluator::load_weights(const std::string &path){
+    //one "name value" pair per line, names are the SITUATION names and enemy_score_multiplier
+    const std::string names[SITUAION_NUMBER] = {"WIN5", "LIVE4", "OPEN4", "LIVE3", "OPEN3"};
+    std::ifstream fin(path);
+    if(!fin) return false;
+    std::string name;
+    float value;
+    while(fin >> name >> value){
+        if(name == "enemy_score_multiplier"){
+            enemy_score_multiplier = value;
+            continue;
+        }
+        for(int i = 0; i < SITUAION_NUMBER; i++){
+            if(name == names[i]){
+                situation_scores[i] = value;
+            }
+        }
+    }
+    return true;
+}
+
+std::vector<float> Evaluator::weights() const{
+    std::vector<float> weights;
+    for(int i = 0; i < SITUAION_NUMBER; i++){
+        weights.push_back(situation_scores.at(i));
+    }
+    weights.push_back(enemy_score_multiplier);
+    return weights;
+}
+
+bool Evaluator::save_weights(const std::string &path) const{
+    const std::string names[SITUAION_NUMBER] = {"WIN5", "LIVE4", "OPEN4", "LIVE3", "OPEN3"};
+    std::ofstream fout(path);
+    if(!fout) return false;
+    for(int i = 0; i < SITUAION_NUMBER; i++){
+        fout << names[i] << ' ' << situation_scores.at(i) << std::endl;
+    }
+    fout << "enemy_score_multiplier " << enemy_score_multiplier << std::endl;
+    return (bool)fout;
+}
+
+bool Evaluator::evaluate_piece(const int x, const int y, const std::vector<std::vector<int>> &board){
+        //update player score # return true if wins (have win5)
+    PlayerScore *curr_player;
+    PlayerScore temp_scores;
+    std::string line;
+    int O, X;
+
+    //init curr player information
+    if(board[x][y] == 1){
+        curr_player = &player1_score;
+        O = 1;
+        X = 2;
+    }
+    else{
+        curr_player = &player2_score;
+        O = 2;
+        X = 1;
+    }
+
+    //horizontal
+    line.clear();
+    if(x - 2 >= 0 && x + 2 < SIZE){
+        //get 5 to check win5
+        for(int i = -2; i <= 2; i++){
+            line.append(get_piece_string(O, X, board[x+i][y]));
+        }
+
+        if(win5_set.find(line) != win5_set.cend()){
+            //if have win5 game is over return
+            curr_player->situation_occurence[WIN5]++;
+            //return true;
+        }
+        else{
+            //get 6 to check open4 and live 4
+            if(x + 3 < SIZE){
+                line.append(get_piece_string(O, X, board[x+3][y]));
+            }
+            else{
+                line.append("X");
+            }
+
+            if(live4_set.find(line) != live4_set.cend()){
+                curr_player->situation_occurence[LIVE4]++;
+            }
+            else if(open4_set.find(line) != open4_set.cend()){
+                curr_player->situation_occurence[OPEN4]++;
+            }
+            else{
+                //get 7 to check open3 and live 3
+                if(x - 3 >= 0){
+                    line = get_piece_string(O, X, board[x-3][y]) + line;
+                }
+                else{
+                    line = "X" + line;
+                }
+                if(live3_set.find(line) != live3_set.cend()){
+                    curr_player->situation_occurence[LIVE3]++;
+                }
+                else if(open3_set.find(line) != open3_set.cend()){
+                    curr_player->situation_occurence[OPEN3]++;
+                }
+            }  
+        }
+    }
+
+    //vertical
+    line.clear();
+    if(y - 2 >= 0 && y + 2 < SIZE){
+        //get 5 to check win5
+        for(int i = -2; i <= 2; i++){
+            line.append(get_piece_string(O, X, board[x][y+i]));
+        }
+
+        if(win5_set.find(line) != win5_set.cend()){
+            //if have win5 game is over return
+            curr_player->situation_occurence[WIN5]++;
+            //return true;
+        }
+        else{
+            //get 6 to check open4 and live 4
+            if(y + 3 < SIZE){
+                line.append(get_piece_string(O, X, board[x][y+3]));
+            }
+            else{
+                line.append("X");
+            }
+
+            if(live4_set.find(line) != live4_set.cend()){
+                curr_player->situation_occurence[LIVE4]++;
+            }
+            else if(open4_set.find(line) != open4_set.cend()){
+                curr_player->situation_occurence[OPEN4]++;
+            }
+            else{
+                //get 7 to check open3 and live 3
+                if(y - 3 >= 0){
+                    line = get_piece_string(O, X, board[x][y-3]) + line;
+                }
+                else{
+                    line = "X" + line;
+                }
+                if(live3_set.find(line) != live3_set.cend()){
+                    curr_player->situation_occurence[LIVE3]++;
+                }
+                else if(open3_set.find(line) != open3_set.cend()){
+                    curr_player->situation_occurence[OPEN3]++;
+                }
+            }  
+        }
+    }
+
+    //down right "\"
+    line.clear();
+    if(y - 2 >= 0 && y + 2 < SIZE && x - 2 >= 0 && x + 2 < SIZE){
+        //get 5 to check win5
+        for(int i = -2; i <= 2; i++){
+            line.append(get_piece_string(O, X, board[x+i][y+i]));
+        }
+
+        if(win5_set.find(line) != win5_set.cend()){
+            //if have win5 game is over return
+            curr_player->situation_occurence[WIN5]++;
+            //return true;
+        }
+        else{
+            //get 6 to check open4 and live 4
+            if(y + 3 < SIZE && x + 3 < SIZE){
+                line.append(get_piece_string(O, X, board[x+3][y+3]));
+            }
+            else{
+                line.append("X");
+            }
+
+            if(live4_set.find(line) != live4_set.cend()){
+                curr_player->situation_occurence[LIVE4]++;
+            }
+            else if(open4_set.find(line) != open4_set.cend()){
+                curr_player->situation_occurence[OPEN4]++;
+            }
+            else{
+                //get 7 to check open3 and live 3
+                if(y - 3 >= 0 && x - 3 >= 0){
+                    line = get_piece_string(O, X, board[x-3][y-3]) + line;
+                }
+                else{
+                    line = "X" + line;
+                }
+                if(live3_set.find(line) != live3_set.cend()){
+                    curr_player->situation_occurence[LIVE3]++;
+                }
+                else if(open3_set.find(line) != open3_set.cend()){
+                    curr_player->situation_occurence[OPEN3]++;
+                }
+            }  
+        }
+    }
+
+    // up right '/'
+    line.clear();
+    if(y - 2 >= 0 && y + 2 < SIZE && x - 2 >= 0 && x + 2 < SIZE){
+        //get 5 to check win5
+        for(int i = -2; i <= 2; i++){
+            line.append(get_piece_string(O, X, board[x+i][y-i]));
+        }
+
+        if(win5_set.find(line) != win5_set.cend()){
+            //if have win5 game is over return
+            curr_player->situation_occurence[WIN5]++;
+            //return true;
+        }
+        else{
+            //get 6 to check open4 and live 4
+            if(y - 3 >= 0 && x + 3 < SIZE){
+                line.append(get_piece_string(O, X, board[x+3][y-3]));
+            }
+            else{
+                line.append("X");
+            }
+
+            if(live4_set.find(line) != live4_set.cend()){
+                curr_player->situation_occurence[LIVE4]++;
+            }
+            else if(open4_set.find(line) != open4_set.cend()){
+                curr_player->situation_occurence[OPEN4]++;
+            }
+            else{
+                //get 7 to check open3 and live 3
+                if(y + 3 < SIZE && x - 3 >= 0){
+                    line = get_piece_string(O, X, board[x-3][y+3]) + line;
+                }
+                else{
+                    line = "X" + line;
+                }
+                
+                if(live3_set.find(line) != live3_set.cend()){
+                    curr_player->situation_occurence[LIVE3]++;
+                }
+                else if(open3_set.find(line) != open3_set.cend()){
+                    curr_player->situation_occurence[OPEN3]++;
+                }
+            }  
+        }
+    }
+
+    return false;
+}
+
+std::string Evaluator::get_piece_string(int O, int X, int piece){
+    switch(piece){
+        case 0:
+            return ".";
+        case 1:
+            if(O == 1){
+                return "O";
+            }
+            else{
+                return "X";
+            }
+        case 2:
+            if(O == 2){
+                return "O";
+            }
+            else{
+                return "X";
+            }
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef GOBANG_EVALUATOR_H
+#define GOBANG_EVALUATOR_H
+
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "config.h"
+
+/*
+TODO:
+1. adjust enemy situaion multiplier
+2. add self2 and enemy2 situations
+3. at end of evaluate piece if theres more then 2, make all values multiply!
+*/
+
+enum SITUATION{
+    WIN5 = 0, //OOOOO
+    LIVE4 = 1, // .OOOO.
+    OPEN4 = 2, // XOOOO. or .O.OOO. or OO.OO one step to winning
+    LIVE3 = 3, //.OOO. or .O.OO.
+    OPEN3 = 4, // XOOO. or .O.OOX or .OO.OX
+    SELF2 = 5,
+    ENEMY2 = 6,
+    NO_SITUATION = 7,
+};
+
+class PlayerScore{
+    public:
+        PlayerScore();
+        friend class Evaluator;
+        friend class WeightTuner;
+    private:
+        std::vector<int> situation_occurence; 
+};
+
+class Evaluator{
+    //Get a map state and output its score
+    public:
+        Evaluator() {};
+        Evaluator(int size, int player);
+        void set_player(int player);
+        float evaluate(const std::vector<std::vector<int>> &board);
+        bool load_weights(const std::string &path);
+        bool save_weights(const std::string &path) const;
+        std::vector<float> weights() const; //situation scores from WIN5 on, then enemy_score_multiplier
+
+        friend class WeightTuner;
+    private:
+        void count_situations(const std::vector<std::vector<int>> &board);
+        bool evaluate_piece(const int x,const int y, const std::vector<std::vector<int>> &board);
+        std::string get_piece_string(int O, int X, int piece);
+        int player;
+        int SIZE;
+        float enemy_score_multiplier = 1.2;
+        std::map<int, float> situation_scores;
+        std::set<std::string> win5_set;
+        std::set<std::string> live4_set;
+        std::set<std::string> open4_set;
+        std::set<std::string> live3_set;
+        std::set<std::string> open3_set;
+        PlayerScore player1_score;
+        PlayerScore player2_score;
+        //own generator, rand() shares one locked state between threads
+        std::minstd_rand noise;
+};
+
+#endif
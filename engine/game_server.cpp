@@ -0,0 +1,158 @@
+#include "game_server.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+
+GameServer::GameServer(int worker_number): searching{0}, stopping{false}, fout{nullptr}{
+    for(int i = 0; i < worker_number; i++){
+        workers.push_back(std::unique_ptr<DecisionMaker>(new DecisionMaker()));
+    }
+    //a depth cut off by its slice goes on where it stopped, the cache keeps what its unfinished root move searched
+    //so the workers always share one, the file cache if there is one
+    SearchCache *cache = SearchCache::shared(workers.front()->evaluation_hash());
+    if(cache == nullptr){
+        memory_cache.reset(new SearchCache());
+        if(memory_cache->open_memory(CACHE_ENTRIES)) cache = memory_cache.get();
+    }
+    for(auto &worker:workers){
+        worker->set_cache(cache);
+    }
+}
+
+void GameServer::run(std::istream &fin, std::ostream &fout){
+    this->fout = &fout;
+    for(size_t i = 0; i < workers.size(); i++){
+        threads.push_back(std::thread(&GameServer::work, this, i));
+    }
+    std::string line;
+    while(std::getline(fin, line) && handle(line)){}
+
+    //let the searches finish before stopping the workers
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this](){ return searching == 0; });
+    stopping = true;
+    ready.notify_all();
+    lock.unlock();
+    for(auto &thread:threads){
+        thread.join();
+    }
+    threads.clear();
+}
+
+bool GameServer::handle(const std::string &line){
+    //returns false on quit
+    std::stringstream ss(line);
+    std::string command, id;
+    ss >> command;
+    if(command.empty()) return true;
+    if(command == "quit") return false;
+    ss >> id;
+    std::lock_guard<std::mutex> lock(mutex);
+    if(command == "close"){
+        auto session = sessions.find(id);
+        if(session != sessions.end()){
+            //a search going on still has its pointer and finishes without a reply
+            session->second->closed = true;
+            sessions.erase(session);
+        }
+    }
+    else if(command == "go"){
+        int time, player;
+        ss >> time >> player;
+        ChessBoard board(SIZE, ss);
+        if(!ss || id.empty()){
+            *fout << "error " << id << " bad go command" << std::endl;
+            return true;
+        }
+        std::shared_ptr<Session> &session = sessions[id];
+        if(!session){
+            session.reset(new Session());
+            session->id = id;
+        }
+        if(session->searching){
+            *fout << "error " << id << " still searching" << std::endl;
+            return true;
+        }
+        session->player = player;
+        session->board = board;
+        session->deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(std::max(1, time));
+        session->continuation = SearchContinuation();
+        session->slice = SERVER_SLICE;
+        session->has_move = false;
+        session->searching = true;
+        searching++;
+        queue.push_back(session);
+        ready.notify_one();
+    }
+    else{
+        *fout << "error " << id << " unknown command " << command << std::endl;
+    }
+    return true;
+}
+
+void GameServer::work(int worker){
+    DecisionMaker &decision_maker = *workers[worker];
+    while(true){
+        std::shared_ptr<Session> session;
+        bool closed;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            ready.wait(lock, [this](){ return stopping || !queue.empty(); });
+            if(queue.empty()) return;
+            session = queue.front();
+            queue.pop_front();
+            closed = session->closed;
+        }
+
+        //only this worker has the session until it is queued again
+        //the depth stops at the deadline, then the best move of the depths before is the reply
+        //the first depth always runs, if the time is already up it stops at once with the first root move as the reply
+        SearchContinuation &continuation = session->continuation;
+        auto left = std::chrono::duration_cast<std::chrono::milliseconds>(session->deadline - std::chrono::steady_clock::now()).count();
+        if(!closed && (left > 0 || !session->has_move)){
+            SearchLimits limits;
+            if(left > 0) limits.time = (int)std::min<long long>(left, session->slice);
+            else limits.nodes = 1;
+            limits.stop = &session->closed;
+            decision_maker.set_position(session->player, session->board);
+            decision_maker.search_iteration(limits, continuation);
+            session->has_move = true;
+            //cut off by the slice, not the deadline: the depth goes on from where it stopped with more time after the others had their turn
+            if(continuation.stopped && limits.time < left){
+                continuation.finished = false;
+                session->slice *= 2;
+            }
+        }
+        else{
+            continuation.finished = true;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if(!session->continuation.finished && !session->closed){
+            queue.push_back(session);
+            ready.notify_one();
+            continue;
+        }
+        if(!session->closed){
+            const SearchResult &result = session->continuation.result;
+            *fout << "move " << session->id << ' ' << result.best_move.x << ' ' << result.best_move.y << ' '
+                  << result.depth << ' ' << result.value << std::endl;
+        }
+        session->searching = false;
+        searching--;
+        idle.notify_all();
+    }
+}
+
+int run_server(int argc, char **argv){
+    int worker_number = std::max(1u, std::thread::hardware_concurrency());
+    for(int i = 2; i < argc; i++){
+        std::string option = argv[i];
+        if(option == "--workers" && i + 1 < argc) worker_number = std::max(1, atoi(argv[++i]));
+        else std::cerr << "unknown option " << option << std::endl;
+    }
+    GameServer server(worker_number);
+    server.run(std::cin, std::cout);
+    return 0;
+}
@@ -0,0 +1,66 @@
+#ifndef GOBANG_GAME_SERVER_H
+#define GOBANG_GAME_SERVER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "chess_board.h"
+#include "decision_maker.h"
+#include "search_cache.h"
+
+class GameServer{
+    //many games in one process, a session only costs its board until it asks for a move
+    //a search runs one depth at a time on a fixed pool of workers and goes to the back of the queue after each depth
+    //so every searching session gets its turn, and the search tables are only built once for every worker
+    //a depth is cut off after SERVER_SLICE ms so a deep one can't keep the others waiting,
+    //it goes on with twice the time and only searches the root moves it didn't finish again
+    //commands, one a line:
+    //  go <id> <time ms> <player> <the 225 cells of the board>  search the position of session id
+    //                                                           replies move <id> <x> <y> <depth> <value> before the time is up
+    //  close <id>                                               forget the session
+    //  quit                                                     finish the searches and stop, so does the end of the input
+    public:
+        GameServer(int worker_number);
+        void run(std::istream &fin, std::ostream &fout);
+    private:
+        struct Session{
+            std::string id;
+            int player;
+            ChessBoard board;
+            std::chrono::steady_clock::time_point deadline;
+            SearchContinuation continuation;
+            int slice; //ms the next depth gets
+            bool has_move; //continuation.result has a legal move
+            bool searching = false;
+            std::atomic<bool> closed{false}; //stops the search going on
+        };
+        bool handle(const std::string &line);
+        void work(int worker);
+        const int SIZE = 15;
+        std::vector<std::unique_ptr<DecisionMaker>> workers;
+        std::unique_ptr<SearchCache> memory_cache; //shared by the workers when there is no file cache
+        std::vector<std::thread> threads;
+        std::map<std::string, std::shared_ptr<Session>> sessions;
+        //sessions waiting for their next depth, first come first served
+        std::deque<std::shared_ptr<Session>> queue;
+        std::mutex mutex; //for everything above and the output
+        std::condition_variable ready; //the queue has a session or the server stops
+        std::condition_variable idle; //a search finished
+        int searching;
+        bool stopping;
+        std::ostream *fout;
+};
+
+//my_player --serve [--workers N], commands come from stdin and replies go to stdout
+int run_server(int argc, char **argv);
+
+#endif
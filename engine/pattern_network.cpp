@@ -0,0 +1,192 @@
+#include "pattern_network.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define PATTERN_AVX2 //avx2 output layer, picked at runtime if the cpu has it
+#endif
+
+std::shared_ptr<const PatternWeights> PatternWeights::shared(){
+    static std::shared_ptr<const PatternWeights> weights = [](){
+        std::shared_ptr<PatternWeights> weights(new PatternWeights());
+        if(!weights->load(PATTERN_WEIGHTS_FILE)){
+            weights.reset();
+        }
+        return std::shared_ptr<const PatternWeights>(weights);
+    }();
+    return weights;
+}
+
+bool PatternWeights::load(const std::string &path){
+    std::ifstream fin(path, std::ios::binary);
+    char magic[4];
+    int32_t version, hidden;
+    if(!fin.read(magic, 4) || std::memcmp(magic, "GBPN", 4) != 0) return false;
+    fin.read((char *)&version, sizeof(version));
+    fin.read((char *)&hidden, sizeof(hidden));
+    if(!fin || version != VERSION || hidden != PATTERN_HIDDEN){
+        std::cerr << path << ": unsupported pattern network" << std::endl;
+        return false;
+    }
+    fin.read((char *)bias, sizeof(bias));
+    fin.read((char *)windows, sizeof(windows));
+    fin.read((char *)output, sizeof(output));
+    fin.read((char *)&output_bias, sizeof(output_bias));
+    fin.read((char *)&output_divisor, sizeof(output_divisor));
+    return fin && output_divisor != 0;
+}
+
+bool PatternWeights::save(const std::string &path) const{
+    std::ofstream fout(path, std::ios::binary);
+    int32_t version = VERSION, hidden = PATTERN_HIDDEN;
+    fout.write("GBPN", 4);
+    fout.write((const char *)&version, sizeof(version));
+    fout.write((const char *)&hidden, sizeof(hidden));
+    fout.write((const char *)bias, sizeof(bias));
+    fout.write((const char *)windows, sizeof(windows));
+    fout.write((const char *)output, sizeof(output));
+    fout.write((const char *)&output_bias, sizeof(output_bias));
+    fout.write((const char *)&output_divisor, sizeof(output_divisor));
+    return (bool)fout;
+}
+
+void PatternWeights::init_window_scores(){
+    //a starting network until there are trained weights: the sum of the scores of all windows
+    //windows with only black pieces count for black, only white for white, both for nobody
+    //the first half of the hidden units add up the positive part of the sum 127 at a time, the second half the negative part
+    const int16_t scores[6] = {0, 1, 4, 20, 120, 600};
+    const int half = PATTERN_HIDDEN/2;
+    for(int pattern = 0; pattern < PATTERN_NUMBER; pattern++){
+        int black = 0, white = 0;
+        for(int i = 0, rest = pattern; i < 5; i++, rest /= 3){
+            if(rest % 3 == 1) black++;
+            if(rest % 3 == 2) white++;
+        }
+        int16_t score = 0;
+        if(white == 0) score = scores[black];
+        if(black == 0) score = -scores[white];
+        for(int d = 0; d < 4; d++){
+            for(int i = 0; i < PATTERN_HIDDEN; i++){
+                windows[d][pattern][i] = (i < half) ? score : -score;
+            }
+        }
+    }
+    for(int i = 0; i < PATTERN_HIDDEN; i++){
+        bias[i] = -127*(i % half);
+        output[i] = (i < half) ? 16 : -16;
+    }
+    output_bias = 0;
+    output_divisor = 1;
+}
+
+#ifdef PATTERN_AVX2
+__attribute__((target("avx2")))
+static int32_t pattern_output_avx2(const int32_t *accumulator, const int16_t *output){
+    //clipped relu to 0..127 then dot product with the output weights, 16 hidden units at a time
+    //the clipped sums fit 16 bits, packing them mixes the 128 bit halves so the permute puts them back in order
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i top = _mm256_set1_epi32(127);
+    __m256i sum = _mm256_setzero_si256();
+    for(int i = 0; i < PATTERN_HIDDEN; i += 16){
+        __m256i low = _mm256_loadu_si256((const __m256i *)(accumulator + i));
+        __m256i high = _mm256_loadu_si256((const __m256i *)(accumulator + i + 8));
+        low = _mm256_min_epi32(_mm256_max_epi32(low, zero), top);
+        high = _mm256_min_epi32(_mm256_max_epi32(high, zero), top);
+        __m256i hidden = _mm256_permute4x64_epi64(_mm256_packs_epi32(low, high), 0xD8);
+        __m256i weight = _mm256_loadu_si256((const __m256i *)(output + i));
+        sum = _mm256_add_epi32(sum, _mm256_madd_epi16(hidden, weight));
+    }
+    __m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+    half = _mm_hadd_epi32(half, half);
+    half = _mm_hadd_epi32(half, half);
+    return _mm_cvtsi128_si32(half);
+}
+#endif
+
+static int32_t pattern_output_scalar(const int32_t *accumulator, const int16_t *output){
+    int32_t sum = 0;
+    for(int i = 0; i < PATTERN_HIDDEN; i++){
+        int32_t hidden = std::min<int32_t>(std::max<int32_t>(accumulator[i], 0), 127);
+        sum += hidden*output[i];
+    }
+    return sum;
+}
+
+
+PatternNetwork::PatternNetwork(int size, std::shared_ptr<const PatternWeights> weights):
+SIZE{size}, weights{weights}{
+    cells = std::vector<std::vector<int>>(SIZE, std::vector<int>(SIZE, 0));
+    std::copy(weights->bias, weights->bias + PATTERN_HIDDEN, accumulator);
+#ifdef PATTERN_AVX2
+    use_avx2 = __builtin_cpu_supports("avx2");
+#else
+    use_avx2 = false;
+#endif
+}
+
+void PatternNetwork::refresh(const std::vector<std::vector<int>> &board){
+    cells = std::vector<std::vector<int>>(SIZE, std::vector<int>(SIZE, 0));
+    std::copy(weights->bias, weights->bias + PATTERN_HIDDEN, accumulator);
+    //the all empty pattern counts too, add those windows once from an empty board
+    const int dx[4] = {1, 0, 1, 1};
+    const int dy[4] = {0, 1, 1, -1};
+    for(int d = 0; d < 4; d++){
+        for(int x = 0; x < SIZE; x++){
+            for(int y = 0; y < SIZE; y++){
+                int ex = x + 4*dx[d], ey = y + 4*dy[d];
+                if(ex < 0 || ex >= SIZE || ey < 0 || ey >= SIZE) continue;
+                const int16_t *weight = weights->windows[d][0];
+                for(int i = 0; i < PATTERN_HIDDEN; i++){
+                    accumulator[i] += weight[i];
+                }
+            }
+        }
+    }
+    for(int x = 0; x < SIZE; x++){
+        for(int y = 0; y < SIZE; y++){
+            if(board[x][y] != 0) update(x, y, board[x][y]);
+        }
+    }
+}
+
+void PatternNetwork::update(int x, int y, int piece){
+    const int dx[4] = {1, 0, 1, 1};
+    const int dy[4] = {0, 1, 1, -1};
+    const int power[5] = {1, 3, 9, 27, 81};
+    int change = piece - cells[x][y];
+    if(change == 0) return;
+    for(int d = 0; d < 4; d++){
+        //the placement is cell k of the window starting k cells before it
+        for(int k = 0; k < 5; k++){
+            int sx = x - k*dx[d], sy = y - k*dy[d];
+            int ex = sx + 4*dx[d], ey = sy + 4*dy[d];
+            if(sx < 0 || sx >= SIZE || sy < 0 || sy >= SIZE || ex < 0 || ex >= SIZE || ey < 0 || ey >= SIZE) continue;
+            int pattern = 0;
+            for(int i = 0; i < 5; i++){
+                pattern += cells[sx + i*dx[d]][sy + i*dy[d]]*power[i];
+            }
+            const int16_t *old_weight = weights->windows[d][pattern];
+            const int16_t *new_weight = weights->windows[d][pattern + change*power[k]];
+            for(int i = 0; i < PATTERN_HIDDEN; i++){
+                accumulator[i] += new_weight[i] - old_weight[i];
+            }
+        }
+    }
+    cells[x][y] = piece;
+}
+
+float PatternNetwork::evaluate(int player) const{
+    //the network scores the board for black
+    int32_t sum;
+#ifdef PATTERN_AVX2
+    if(use_avx2) sum = pattern_output_avx2(accumulator, weights->output);
+    else sum = pattern_output_scalar(accumulator, weights->output);
+#else
+    sum = pattern_output_scalar(accumulator, weights->output);
+#endif
+    float score = (float)(sum + weights->output_bias)/weights->output_divisor;
+    return (player == 1) ? score : -score;
+}
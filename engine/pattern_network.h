@@ -0,0 +1,49 @@
+#ifndef GOBANG_PATTERN_NETWORK_H
+#define GOBANG_PATTERN_NETWORK_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "config.h"
+
+class PatternWeights{
+    //every 5 cells on a line (a window) is one of 3^5 patterns, each pattern of each direction has a weight vector
+    //file: "GBPN", int32 version, int32 hidden size, then the arrays below in order, all little endian
+    public:
+        static const int PATTERN_NUMBER = 243;
+        //PATTERN_WEIGHTS_FILE loaded once and shared by every network of the process, nullptr if it can't be loaded
+        static std::shared_ptr<const PatternWeights> shared();
+        bool load(const std::string &path);
+        bool save(const std::string &path) const;
+        void init_window_scores();
+
+        int16_t bias[PATTERN_HIDDEN];
+        int16_t windows[4][PATTERN_NUMBER][PATTERN_HIDDEN];
+        int16_t output[PATTERN_HIDDEN];
+        int32_t output_bias;
+        int32_t output_divisor;
+    private:
+        static const int32_t VERSION = 1;
+};
+
+class PatternNetwork{
+    //keeps the sum of the weights of every window on the board (the accumulator)
+    //a placement only changes the windows through it, so the accumulator is updated instead of built again
+    //the sums are 32 bit, a full board of int16 weights can't wrap them
+    public:
+        PatternNetwork() {};
+        PatternNetwork(int size, std::shared_ptr<const PatternWeights> weights);
+        void refresh(const std::vector<std::vector<int>> &board);
+        void update(int x, int y, int piece);
+        float evaluate(int player) const;
+    private:
+        int SIZE;
+        std::shared_ptr<const PatternWeights> weights;
+        std::vector<std::vector<int>> cells;
+        int32_t accumulator[PATTERN_HIDDEN];
+        bool use_avx2;
+};
+
+#endif
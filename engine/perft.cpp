@@ -0,0 +1,135 @@
+#include "perft.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "point.h"
+#include "chess_board.h"
+#include "decision_maker.h"
+
+void perft_oracle(std::vector<std::vector<int>> &board, int ply, int depth, int curr_player, std::vector<long long> &counts){
+    //the same counts as DecisionMaker::perft but every move set is found again from the whole board
+    //slow on purpose, it shares no code with the move generator
+    const int size = board.size();
+    std::vector<Point> steps;
+    bool found = false;
+    for(int x = 0; x < size && !found; x++){
+        for(int y = 0; y < size && !found; y++){
+            found = board[x][y] != 0;
+        }
+    }
+    for(int x = 0; x < size; x++){
+        for(int y = 0; y < size; y++){
+            if(board[x][y] != 0) continue;
+            bool near = !found && x == 7 && y == 7;
+            for(int dx = -2; dx <= 2 && !near; dx++){
+                for(int dy = -2; dy <= 2 && !near; dy++){
+                    int nx = x + dx, ny = y + dy;
+                    near = nx >= 0 && nx < size && ny >= 0 && ny < size && board[nx][ny] != 0;
+                }
+            }
+            if(near) steps.push_back(Point(x, y));
+        }
+    }
+    counts[ply] += steps.size();
+    if(ply == depth) return;
+    for(auto &step:steps){
+        board[step.x][step.y] = curr_player;
+        perft_oracle(board, ply+1, depth, (curr_player == 1) ? 2:1, counts);
+        board[step.x][step.y] = 0;
+    }
+}
+
+int run_perft(int argc, char **argv){
+    //positions are written like the state file one after another
+    //a reference file has one line of counts (depth 1 to N) for every position
+    //the oracle only knows the raw move generator, the --tree counts are checked against the reference
+    //and every move in them must be one the raw generator gives
+    if(argc < 4){
+        std::cerr << "usage: " << argv[0] << " --perft <positions> <depth> [--reference <counts>] [--no-oracle] [--tree]" << std::endl;
+        std::cerr << "  checks the raw move generator against the oracle, --tree counts the filtered moves the search uses instead" << std::endl;
+        return 1;
+    }
+    const int SIZE = 15;
+    int depth = std::max(1, atoi(argv[3]));
+    bool use_oracle = true;
+    bool tree = false;
+    std::ifstream reference;
+    for(int i = 4; i < argc; i++){
+        std::string option = argv[i];
+        if(option == "--no-oracle") use_oracle = false;
+        else if(option == "--tree") tree = true;
+        else if(option == "--reference" && i + 1 < argc) reference.open(argv[++i]);
+        else std::cerr << "unknown option " << option << std::endl;
+    }
+
+    std::ifstream fin(argv[2]);
+    DecisionMaker decision_maker;
+    StateReader reader(fin, SIZE);
+    int player, position = 0;
+    ChessBoard board;
+    bool passed = true;
+    long long total_moves = 0;
+    double total_seconds = 0;
+    while(reader.next(player, board)){
+        position++;
+        decision_maker.set_position(player, board);
+
+        bool restored;
+        auto start = std::chrono::steady_clock::now();
+        std::vector<long long> counts = tree ? decision_maker.perft_tree(depth, restored) : decision_maker.perft(depth, restored);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        long long moves = 0;
+
+        std::vector<long long> expected;
+        std::string line;
+        if(reference.is_open() && std::getline(reference, line)){
+            std::stringstream ss(line);
+            long long count;
+            while(ss >> count) expected.push_back(count);
+        }
+        std::vector<long long> oracle_counts;
+        if(use_oracle && !tree){
+            oracle_counts = std::vector<long long>(depth + 1, 0);
+            std::vector<std::vector<int>> oracle_board;
+            for(int x = 0; x < SIZE; x++){
+                oracle_board.push_back(board[x]);
+            }
+            perft_oracle(oracle_board, 1, depth, player, oracle_counts);
+        }
+
+        const char *broken = tree ? " a move outside the generator or possible steps not restored!" : " possible steps not restored!";
+        std::cout << "position " << position << (restored ? "" : broken) << std::endl;
+        passed = passed && restored;
+        for(int d = 1; d <= depth; d++){
+            std::cout << "depth " << d << ": " << counts[d];
+            if(!oracle_counts.empty()){
+                std::cout << " oracle " << oracle_counts[d];
+                if(oracle_counts[d] != counts[d]){
+                    std::cout << " MISMATCH";
+                    passed = false;
+                }
+            }
+            if((size_t)d <= expected.size()){
+                std::cout << " reference " << expected[d-1];
+                if(expected[d-1] != counts[d]){
+                    std::cout << " MISMATCH";
+                    passed = false;
+                }
+            }
+            std::cout << std::endl;
+            moves += counts[d];
+        }
+        total_moves += moves;
+        total_seconds += seconds;
+        std::cout << "moves/sec: " << (long long)(moves/std::max(seconds, 1e-9)) << std::endl;
+    }
+    std::cout << (passed ? "passed" : "FAILED") << ", " << position << " positions, "
+              << (long long)(total_moves/std::max(total_seconds, 1e-9)) << " moves/sec" << std::endl;
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,14 @@
+#ifndef GOBANG_PERFT_H
+#define GOBANG_PERFT_H
+
+#include <vector>
+
+//count every move sequence of each length from board without the move generator
+void perft_oracle(std::vector<std::vector<int>> &board, int ply, int depth, int curr_player, std::vector<long long> &counts);
+
+//my_player --perft <positions> <depth> [--reference <counts>] [--no-oracle] [--tree]
+//the oracle checks the raw move generator, --tree counts the moves create_tree leaves for the search
+//(forced moves, mirror images removed, a won game is not played on) and is only checked against the reference
+int run_perft(int argc, char **argv);
+
+#endif
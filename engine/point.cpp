@@ -0,0 +1,29 @@
+#include "point.h"
+
+Point::Point(): x{0}, y{0} {};
+
+Point::Point(int x, int y): x{x}, y{y} {};
+
+Point Point::operator+(const Point &rhs) const{
+    return Point(x + rhs.x, y + rhs.y);
+}
+
+Point Point::operator-(const Point &rhs) const{
+    return Point(x - rhs.x, y - rhs.y);
+}
+
+bool Point::operator<(const Point &rhs) const{
+    if(x == rhs.x){
+        return y < rhs.y;
+    }
+    return x < rhs.x;
+}
+
+bool Point::operator==(const Point &rhs) const{
+    return x == rhs.x && y == rhs.y;
+}
+
+std::ostream& operator<<(std::ostream& os, const Point& p){
+    os << '(' << p.x << ", " << p.y << ')';
+    return os;
+}
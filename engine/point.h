@@ -0,0 +1,23 @@
+#ifndef GOBANG_POINT_H
+#define GOBANG_POINT_H
+
+#include <iostream>
+
+class Point{
+    // cords are 0-14
+    public:
+        Point();
+        Point(int x, int y);
+        Point operator+(const Point &rhs) const;
+        Point operator-(const Point &rhs) const;
+        bool operator<(const Point &rhs) const;
+        bool operator==(const Point &rhs) const;
+
+        friend std::ostream& operator<<(std::ostream& os, const Point& p);
+
+        int x;
+        int y;
+    private:
+};
+
+#endif
@@ -0,0 +1,273 @@
+#include "position_corpus.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const uint32_t CORPUS_VERSION = 1;
+static const int CORPUS_SIZE = 15;
+static const size_t CORPUS_HEADER_SIZE = 64;
+static_assert(sizeof(CorpusRecord) == 64, "corpus records must stay 64 bytes");
+
+CorpusRecord encode_position(int player, const ChessBoard &board){
+    CorpusRecord record;
+    std::memset(&record, 0, sizeof(record));
+    for(int x = 0; x < CORPUS_SIZE; x++){
+        for(int y = 0; y < CORPUS_SIZE; y++){
+            int i = x*CORPUS_SIZE + y;
+            record.cells[i/4] |= (board[x][y] & 3) << (2*(i%4));
+        }
+    }
+    record.player = (uint8_t)player;
+    return record;
+}
+
+ChessBoard decode_board(const CorpusRecord &record){
+    std::vector<std::vector<int>> board(CORPUS_SIZE, std::vector<int>(CORPUS_SIZE));
+    for(int x = 0; x < CORPUS_SIZE; x++){
+        for(int y = 0; y < CORPUS_SIZE; y++){
+            int i = x*CORPUS_SIZE + y;
+            board[x][y] = (record.cells[i/4] >> (2*(i%4))) & 3;
+        }
+    }
+    return ChessBoard(board);
+}
+
+int read_game_log(const std::string &path, std::vector<std::pair<int, ChessBoard>> &positions, std::vector<float> &results){
+    std::ifstream fin(path);
+    std::string line;
+    std::vector<std::pair<int, ChessBoard>> game;
+    int loaded = 0;
+    auto finish_game = [&](const std::string &winner_line){
+        //games lost by an invalid move don't tell anything about the positions
+        if(winner_line.find("invalid") == std::string::npos){
+            float black_result = 0.5;
+            if(winner_line.find("Winner is O") != std::string::npos) black_result = 1.0;
+            if(winner_line.find("Winner is X") != std::string::npos) black_result = 0.0;
+            for(auto &position:game){
+                positions.push_back(position);
+                results.push_back(position.first == 1 ? black_result : 1.0 - black_result);
+                loaded++;
+            }
+        }
+        game.clear();
+    };
+
+    while(std::getline(fin, line)){
+        if(line.compare(0, 10, "Timestep #") != 0) continue;
+        if(line == "Timestep #1") game.clear();
+        std::string turn_line, border;
+        std::getline(fin, turn_line);
+        std::getline(fin, border);
+        ChessBoard board;
+        std::stringstream ss;
+        for(int i = 0; i < CORPUS_SIZE && std::getline(fin, line); i++){
+            //|. O X ...|
+            for(int j = 0; j < CORPUS_SIZE; j++){
+                char c = (line.size() > (size_t)(1 + 2*j)) ? line[1 + 2*j] : '.';
+                ss << (c == 'O' ? 1 : (c == 'X' ? 2 : 0)) << ' ';
+            }
+        }
+        board = ChessBoard(CORPUS_SIZE, ss);
+        if(turn_line.compare(0, 9, "Winner is") == 0){
+            finish_game(turn_line);
+        }
+        else{
+            game.push_back(std::make_pair(turn_line[0] == 'O' ? 1 : 2, board));
+        }
+    }
+    return loaded;
+}
+
+// ----- Writer ----- //
+
+CorpusWriter::CorpusWriter(const std::string &path): fout(path, std::ios::binary), count{0}{
+    //the header is written again with the count when closing
+    char header[CORPUS_HEADER_SIZE] = {};
+    fout.write(header, sizeof(header));
+}
+
+CorpusWriter::~CorpusWriter(){
+    if(fout.is_open()) close();
+}
+
+bool CorpusWriter::add(const CorpusRecord &record){
+    fout.write((const char *)&record, sizeof(record));
+    count++;
+    return (bool)fout;
+}
+
+bool CorpusWriter::close(){
+    char header[CORPUS_HEADER_SIZE] = {};
+    uint32_t version = CORPUS_VERSION, size = CORPUS_SIZE, record_size = sizeof(CorpusRecord);
+    std::memcpy(header, "GBPC", 4);
+    std::memcpy(header + 4, &version, sizeof(version));
+    std::memcpy(header + 8, &count, sizeof(count));
+    std::memcpy(header + 16, &size, sizeof(size));
+    std::memcpy(header + 20, &record_size, sizeof(record_size));
+    fout.seekp(0);
+    fout.write(header, sizeof(header));
+    bool written = (bool)fout;
+    fout.close();
+    return written;
+}
+
+uint64_t CorpusWriter::size() const{
+    return count;
+}
+
+// ----- Reader ----- //
+
+CorpusReader::~CorpusReader(){
+    close();
+}
+
+bool CorpusReader::is_corpus(const std::string &path){
+    std::ifstream fin(path, std::ios::binary);
+    char magic[4];
+    return fin.read(magic, 4) && std::memcmp(magic, "GBPC", 4) == 0;
+}
+
+bool CorpusReader::open(const std::string &path){
+    close();
+    const char *data = nullptr;
+    size_t size = 0;
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    struct stat file_stat;
+    if(fd >= 0 && fstat(fd, &file_stat) == 0 && file_stat.st_size > 0){
+        void *mapped = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(mapped != MAP_FAILED){
+            memory = mapped;
+            memory_size = file_stat.st_size;
+            data = (const char *)mapped;
+            size = memory_size;
+        }
+    }
+    if(fd >= 0) ::close(fd);
+#endif
+    if(data == nullptr){
+        //no mmap, read the whole file
+        std::ifstream fin(path, std::ios::binary);
+        buffer.assign(std::istreambuf_iterator<char>(fin), std::istreambuf_iterator<char>());
+        data = buffer.data();
+        size = buffer.size();
+    }
+
+    uint32_t version = 0, board_size = 0, record_size = 0;
+    uint64_t record_count = 0;
+    if(size >= CORPUS_HEADER_SIZE){
+        std::memcpy(&version, data + 4, sizeof(version));
+        std::memcpy(&record_count, data + 8, sizeof(record_count));
+        std::memcpy(&board_size, data + 16, sizeof(board_size));
+        std::memcpy(&record_size, data + 20, sizeof(record_size));
+    }
+    if(size < CORPUS_HEADER_SIZE || std::memcmp(data, "GBPC", 4) != 0 || version != CORPUS_VERSION ||
+       board_size != CORPUS_SIZE || record_size != sizeof(CorpusRecord) || record_count > (size - CORPUS_HEADER_SIZE)/record_size){
+        std::cerr << path << ": not a position corpus or cut short" << std::endl;
+        close();
+        return false;
+    }
+    records = (const CorpusRecord *)(data + CORPUS_HEADER_SIZE);
+    count = record_count;
+    return true;
+}
+
+void CorpusReader::close(){
+#ifndef _WIN32
+    if(memory != nullptr){
+        munmap((void *)memory, memory_size);
+    }
+#endif
+    memory = nullptr;
+    std::vector<char>().swap(buffer);
+    records = nullptr;
+    count = 0;
+}
+
+size_t CorpusReader::size() const{
+    return count;
+}
+
+const CorpusRecord &CorpusReader::operator[](size_t i) const{
+    return records[i];
+}
+
+// ----- Converters ----- //
+
+int run_corpus(int argc, char **argv){
+    if(argc < 4){
+        std::cerr << "usage: " << argv[0] << " --corpus from-state <output> <positions...>" << std::endl;
+        std::cerr << "       " << argv[0] << " --corpus from-log <output> <game logs...>" << std::endl;
+        std::cerr << "       " << argv[0] << " --corpus dump <corpus> [first] [count]" << std::endl;
+        return 1;
+    }
+    std::string mode = argv[2];
+    if(mode == "dump"){
+        CorpusReader corpus;
+        if(!corpus.open(argv[3])) return 1;
+        size_t first = (argc > 4) ? atoll(argv[4]) : 0;
+        size_t count = (argc > 5) ? atoll(argv[5]) : corpus.size();
+        for(size_t i = first; i < corpus.size() && i < first + count; i++){
+            ChessBoard board = decode_board(corpus[i]);
+            std::cout << (int)corpus[i].player << '\n';
+            for(int x = 0; x < CORPUS_SIZE; x++){
+                for(int y = 0; y < CORPUS_SIZE; y++){
+                    std::cout << board[x][y] << (y + 1 < CORPUS_SIZE ? ' ' : '\n');
+                }
+            }
+        }
+        return 0;
+    }
+
+    //the writer truncates the output, so everything is checked before it is opened
+    if(mode != "from-state" && mode != "from-log"){
+        std::cerr << "unknown corpus mode " << mode << std::endl;
+        return 1;
+    }
+    for(int i = 4; i < argc; i++){
+        if(!std::ifstream(argv[i])){
+            std::cerr << "can't open " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    CorpusWriter writer(argv[3]);
+    for(int i = 4; i < argc; i++){
+        uint64_t before = writer.size();
+        if(mode == "from-state"){
+            //positions are written like the state file one after another
+            std::ifstream fin(argv[i]);
+            StateReader reader(fin, CORPUS_SIZE);
+            int player;
+            ChessBoard board;
+            while(reader.next(player, board)){
+                writer.add(encode_position(player, board));
+            }
+        }
+        else{
+            std::vector<std::pair<int, ChessBoard>> positions;
+            std::vector<float> results;
+            read_game_log(argv[i], positions, results);
+            for(size_t j = 0; j < positions.size(); j++){
+                CorpusRecord record = encode_position(positions[j].first, positions[j].second);
+                record.flags |= CORPUS_LABEL;
+                record.label = (results[j] > 0.5) ? 1 : (results[j] < 0.5) ? -1 : 0;
+                writer.add(record);
+            }
+        }
+        std::cout << argv[i] << ": " << writer.size() - before << " positions" << std::endl;
+    }
+    if(!writer.close()){
+        std::cerr << "can't write " << argv[3] << std::endl;
+        return 1;
+    }
+    return 0;
+}
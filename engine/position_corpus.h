@@ -0,0 +1,70 @@
+#ifndef GOBANG_POSITION_CORPUS_H
+#define GOBANG_POSITION_CORPUS_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "chess_board.h"
+
+enum CORPUS_FLAG{
+    CORPUS_LABEL = 1, //label is set
+    CORPUS_SCORE = 2, //score is set
+};
+
+struct CorpusRecord{
+    //one position in 64 bytes, the board is 2 bits a cell, cell x*15+y is bits 2*(i%4) of byte i/4
+    uint8_t cells[57];
+    uint8_t player; //the one to move
+    uint8_t flags;
+    int8_t label; //game result for the one to move: 1 win, 0 draw, -1 loss
+    float score; //for the one to move
+};
+
+//a board no bigger than 15x15 into a record and back
+CorpusRecord encode_position(int player, const ChessBoard &board);
+ChessBoard decode_board(const CorpusRecord &record);
+
+//every position of the gamelog.txt written by main with the result for the one to move (1 win, 0.5 draw, 0 loss)
+//games lost by an invalid move are skipped, returns the number of positions read
+int read_game_log(const std::string &path, std::vector<std::pair<int, ChessBoard>> &positions, std::vector<float> &results);
+
+class CorpusWriter{
+    //file: "GBPC", uint32 version, uint64 record count, uint32 board size, uint32 record size, zeros to 64 bytes, then the records
+    public:
+        CorpusWriter(const std::string &path);
+        ~CorpusWriter();
+        bool add(const CorpusRecord &record);
+        bool close(); //writes the record count
+        uint64_t size() const;
+    private:
+        std::ofstream fout;
+        uint64_t count;
+};
+
+class CorpusReader{
+    //the whole file is memory mapped, record i is found without reading the ones before it
+    public:
+        CorpusReader() {};
+        ~CorpusReader();
+        static bool is_corpus(const std::string &path);
+        bool open(const std::string &path);
+        size_t size() const;
+        const CorpusRecord &operator[](size_t i) const;
+    private:
+        void close();
+        const void *memory = nullptr;
+        size_t memory_size = 0;
+        std::vector<char> buffer; //the file when it can't be mapped
+        const CorpusRecord *records = nullptr;
+        size_t count = 0;
+};
+
+//my_player --corpus from-state <output> <positions...>
+//my_player --corpus from-log <output> <game logs...>
+//my_player --corpus dump <corpus> [first] [count], writes the positions like the state file
+int run_corpus(int argc, char **argv);
+
+#endif
@@ -0,0 +1,298 @@
+#include "proof_solver.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+
+ProofSolver::ProofSolver(){
+    threat_detector = ThreatDetector(SIZE);
+    Entry empty;
+    empty.key = 0;
+    empty.pn = 1;
+    empty.dn = 1;
+    empty.best = Point(-1, -1);
+    table = std::vector<Entry>(SOLVER_TABLE_SIZE, empty);
+}
+
+ProofResult ProofSolver::solve(int player, const ChessBoard &board, long long node_limit, int time_limit){
+    //try to prove a win first, then a loss with what is left
+    ProofResult win = prove_win(player, board, (node_limit + 1)/2, (time_limit + 1)/2);
+    if(win.result != PROOF_UNKNOWN){
+        return win;
+    }
+    long long nodes_left = (node_limit > 0) ? std::max(1LL, node_limit - win.nodes) : 0;
+    int time_left = (time_limit > 0) ? std::max(1, time_limit - (int)(win.seconds*1000)) : 0;
+    ProofResult loss = prove_loss(player, board, nodes_left, time_left);
+    loss.nodes += win.nodes;
+    loss.seconds += win.seconds;
+    return loss;
+}
+
+ProofResult ProofSolver::prove_win(int player, const ChessBoard &board, long long node_limit, int time_limit){
+    return run(player, player, board, node_limit, time_limit);
+}
+
+ProofResult ProofSolver::prove_loss(int player, const ChessBoard &board, long long node_limit, int time_limit){
+    return run(player, (player == 1) ? 2:1, board, node_limit, time_limit);
+}
+
+ProofResult ProofSolver::run(int curr_player, int attacker, const ChessBoard &board, long long node_limit, int time_limit){
+    this->board = board;
+    this->board.network = nullptr;
+    this->attacker = attacker;
+    this->node_limit = node_limit;
+    this->time_limit = time_limit;
+    start_time = std::chrono::steady_clock::now();
+    nodes = 0;
+    stopped = false;
+    neighbours = std::vector<std::vector<int>>(SIZE, std::vector<int>(SIZE, 0));
+    for(int x = 0; x < SIZE; x++){
+        for(int y = 0; y < SIZE; y++){
+            if(this->board.is_empty(x, y)) continue;
+            for(int nx = std::max(0, x-2); nx <= std::min(SIZE-1, x+2); nx++){
+                for(int ny = std::max(0, y-2); ny <= std::min(SIZE-1, y+2); ny++){
+                    neighbours[nx][ny]++;
+                }
+            }
+        }
+    }
+
+    multiple_iterative_deepening(curr_player, INF, INF);
+
+    ProofResult result;
+    Entry root = lookup(node_key(this->board.get_hash(), curr_player));
+    if(root.pn == 0){
+        result.result = (curr_player == attacker) ? PROOF_WIN : PROOF_LOSS;
+        result.move = root.best;
+    }
+    result.nodes = nodes;
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    return result;
+}
+
+void ProofSolver::multiple_iterative_deepening(int curr_player, unsigned int pn_threshold, unsigned int dn_threshold){
+    //search below the node until its proof or disproof number reaches the threshold
+    nodes++;
+    if(stopped || out_of_budget()){
+        stopped = true;
+        return;
+    }
+    bool attacking = (curr_player == attacker);
+    unsigned long long key = node_key(board.get_hash(), curr_player);
+    std::vector<Move> moves;
+    unsigned int pn, dn;
+    if(generate_moves(curr_player, moves, pn, dn)){
+        store(key, pn, dn, moves.empty() ? Point(-1, -1) : moves.front().placement);
+        return;
+    }
+
+    int next_player = (curr_player == 1) ? 2:1;
+    std::vector<unsigned long long> child_keys;
+    for(auto &move:moves){
+        child_keys.push_back(node_key(board.get_hash() ^ ChessBoard::zobrist_key(move.placement.x, move.placement.y, curr_player), next_player));
+    }
+    while(true){
+        //the attacker needs one proven child, the defender needs all childs proven
+        pn = attacking ? INF : 0;
+        dn = attacking ? 0 : INF;
+        size_t best = 0;
+        unsigned int best_value = INF, second_value = INF, best_pn = 1, best_dn = 1;
+        for(size_t i = 0; i < moves.size(); i++){
+            Entry child = lookup(child_keys[i]);
+            unsigned int value = attacking ? child.pn : child.dn;
+            if(attacking){
+                pn = std::min(pn, child.pn);
+                dn = std::min(INF, dn + child.dn);
+            }
+            else{
+                pn = std::min(INF, pn + child.pn);
+                dn = std::min(dn, child.dn);
+            }
+            if(value < best_value){
+                second_value = best_value;
+                best_value = value;
+                best = i;
+                best_pn = child.pn;
+                best_dn = child.dn;
+            }
+            else if(value < second_value){
+                second_value = value;
+            }
+        }
+        store(key, pn, dn, moves[best].placement);
+        if(pn >= pn_threshold || dn >= dn_threshold || stopped){
+            break;
+        }
+
+        //the best child is searched until it is no longer the best one
+        unsigned int child_pn_threshold, child_dn_threshold;
+        if(attacking){
+            child_pn_threshold = std::min(pn_threshold, second_value + 1);
+            child_dn_threshold = std::min(INF, dn_threshold - dn + best_dn);
+        }
+        else{
+            child_pn_threshold = std::min(INF, pn_threshold - pn + best_pn);
+            child_dn_threshold = std::min(dn_threshold, second_value + 1);
+        }
+        place_piece(moves[best].placement, curr_player);
+        multiple_iterative_deepening(next_player, child_pn_threshold, child_dn_threshold);
+        remove_piece(moves[best].placement);
+    }
+}
+
+bool ProofSolver::generate_moves(int curr_player, std::vector<Move> &moves, unsigned int &pn, unsigned int &dn){
+    //moves of curr_player, returns true with pn and dn set if the node is decided without searching
+    bool attacking = (curr_player == attacker);
+    int next_player = (curr_player == 1) ? 2:1;
+    int best_attack = NO_SITUATION;
+    int best_defence = NO_SITUATION;
+    for(int x = 0; x < SIZE; x++){
+        for(int y = 0; y < SIZE; y++){
+            if(neighbours[x][y] == 0 || !board.is_empty(x, y)) continue;
+            Move move;
+            move.placement = Point(x, y);
+            move.attack = threat_detector.move_situation(board.board, x, y, curr_player);
+            move.defence = threat_detector.move_situation(board.board, x, y, next_player);
+            best_attack = std::min(best_attack, move.attack);
+            best_defence = std::min(best_defence, move.defence);
+            moves.push_back(move);
+        }
+    }
+
+    std::function<bool(const Move &)> is_kept;
+    if(best_attack == WIN5){
+        //the one to move makes five
+        moves.erase(std::remove_if(moves.begin(), moves.end(), [](const Move &move){ return move.attack != WIN5; }), moves.end());
+        pn = attacking ? 0 : INF;
+        dn = attacking ? INF : 0;
+        return true;
+    }
+    else if(best_defence == WIN5){
+        //the other one has a four, only blocking it doesn't lose at once
+        is_kept = [](const Move &move){ return move.defence == WIN5; };
+    }
+    else if(attacking){
+        //the attacker only plays threats so the defender always has to answer
+        is_kept = [](const Move &move){ return move.attack <= LIVE3; };
+    }
+    //a defender facing a three keeps every move, the forced move filter of the search drops answers
+    //like breaking the three of a four-three and a proof can't rely on it
+    if(is_kept){
+        moves.erase(std::remove_if(moves.begin(), moves.end(), [&](const Move &move){ return !is_kept(move); }), moves.end());
+    }
+    if(moves.empty()){
+        //the attacker ran out of threats or the board is full
+        pn = INF;
+        dn = 0;
+        return true;
+    }
+
+    std::stable_sort(moves.begin(), moves.end(), [this](const Move &a, const Move &b){
+        return threat_detector.situation_score(a.attack) + threat_detector.situation_score(a.defence) >
+               threat_detector.situation_score(b.attack) + threat_detector.situation_score(b.defence);
+    });
+    return false;
+}
+
+void ProofSolver::place_piece(Point &point, int curr_player){
+    board.add_piece(point, curr_player);
+    for(int x = std::max(0, point.x-2); x <= std::min(SIZE-1, point.x+2); x++){
+        for(int y = std::max(0, point.y-2); y <= std::min(SIZE-1, point.y+2); y++){
+            neighbours[x][y]++;
+        }
+    }
+}
+
+void ProofSolver::remove_piece(Point &point){
+    board.delete_piece(point);
+    for(int x = std::max(0, point.x-2); x <= std::min(SIZE-1, point.x+2); x++){
+        for(int y = std::max(0, point.y-2); y <= std::min(SIZE-1, point.y+2); y++){
+            neighbours[x][y]--;
+        }
+    }
+}
+
+unsigned long long ProofSolver::node_key(unsigned long long hash, int curr_player) const{
+    //the same pieces are a different node for the other side to move or the other attacker
+    if(curr_player == 2) hash ^= 0x9e3779b97f4a7c15ULL;
+    if(attacker == 2) hash ^= 0x632be59bd9b4e019ULL;
+    return hash;
+}
+
+ProofSolver::Entry ProofSolver::lookup(unsigned long long key) const{
+    const Entry &entry = table[key & (SOLVER_TABLE_SIZE - 1)];
+    if(entry.key == key){
+        return entry;
+    }
+    //not searched yet
+    Entry unknown;
+    unknown.key = key;
+    unknown.pn = 1;
+    unknown.dn = 1;
+    unknown.best = Point(-1, -1);
+    return unknown;
+}
+
+void ProofSolver::store(unsigned long long key, unsigned int pn, unsigned int dn, const Point &best){
+    Entry &entry = table[key & (SOLVER_TABLE_SIZE - 1)];
+    entry.key = key;
+    entry.pn = pn;
+    entry.dn = dn;
+    entry.best = best;
+}
+
+bool ProofSolver::out_of_budget(){
+    if(node_limit > 0 && nodes >= node_limit){
+        return true;
+    }
+    //a node looks at every move with the threat detector, reading the clock is cheap next to it
+    if(time_limit > 0){
+        auto used = std::chrono::steady_clock::now() - start_time;
+        return std::chrono::duration_cast<std::chrono::milliseconds>(used).count() >= time_limit;
+    }
+    return false;
+}
+
+int run_solve(int argc, char **argv){
+    //one line for every position: win x y, loss or unknown, then the nodes and ms used
+    if(argc < 3){
+        std::cerr << "usage: " << argv[0] << " --solve <positions> [--nodes N] [--time ms]" << std::endl;
+        return 1;
+    }
+    const int SIZE = 15;
+    long long node_limit = 1000000;
+    int time_limit = 0;
+    for(int i = 3; i < argc; i++){
+        std::string option = argv[i];
+        if(option == "--nodes" && i + 1 < argc) node_limit = atoll(argv[++i]);
+        else if(option == "--time" && i + 1 < argc) time_limit = atoi(argv[++i]);
+        else std::cerr << "unknown option " << option << std::endl;
+    }
+
+    std::ifstream fin(argv[2]);
+    if(!fin){
+        std::cerr << "can't open " << argv[2] << std::endl;
+        return 1;
+    }
+    ProofSolver solver;
+    StateReader reader(fin, SIZE);
+    int player;
+    ChessBoard board;
+    while(reader.next(player, board)){
+        ProofResult result = solver.solve(player, board, node_limit, time_limit);
+        if(result.result == PROOF_WIN){
+            std::cout << "win " << result.move.x << ' ' << result.move.y;
+        }
+        else if(result.result == PROOF_LOSS){
+            std::cout << "loss";
+        }
+        else{
+            std::cout << "unknown";
+        }
+        std::cout << ' ' << result.nodes << " nodes " << (long long)(result.seconds*1000) << "ms" << std::endl;
+    }
+    return 0;
+}
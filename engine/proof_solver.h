@@ -0,0 +1,78 @@
+#ifndef GOBANG_PROOF_SOLVER_H
+#define GOBANG_PROOF_SOLVER_H
+
+#include <chrono>
+#include <vector>
+
+#include "config.h"
+#include "point.h"
+#include "chess_board.h"
+#include "threat_detector.h"
+
+enum PROOF{
+    PROOF_LOSS = -1, //every move of the side to move loses
+    PROOF_UNKNOWN = 0, //nothing proven before the limit
+    PROOF_WIN = 1, //move wins for the side to move
+};
+
+struct ProofResult{
+    int result = PROOF_UNKNOWN;
+    Point move = Point(-1, -1); //the winning move if result is PROOF_WIN
+    long long nodes = 0;
+    double seconds = 0;
+};
+
+class ProofSolver{
+    //depth first proof number search (df-pn) of wins made with threats
+    //the attacker only plays fours and threes (or blocks a four of the defender)
+    //the defender blocks a four and plays every move within 2 of a piece against anything else
+    //so a proven win holds against every defence near the pieces, but a win that needs a quiet move is not found
+    public:
+        ProofSolver();
+        //nodes and time (ms) are split between trying to prove a win and a loss, 0 means no limit
+        ProofResult solve(int player, const ChessBoard &board, long long node_limit, int time_limit);
+        ProofResult prove_win(int player, const ChessBoard &board, long long node_limit, int time_limit);
+        ProofResult prove_loss(int player, const ChessBoard &board, long long node_limit, int time_limit);
+    private:
+        struct Entry{
+            unsigned long long key;
+            unsigned int pn;
+            unsigned int dn;
+            Point best; //child with the smallest proof number at the attacker's nodes
+        };
+        struct Move{
+            Point placement;
+            int attack; //situation the move creates for the one who moves
+            int defence; //situation the move takes away from the other one
+        };
+        ProofResult run(int curr_player, int attacker, const ChessBoard &board, long long node_limit, int time_limit);
+        void multiple_iterative_deepening(int curr_player, unsigned int pn_threshold, unsigned int dn_threshold);
+        bool generate_moves(int curr_player, std::vector<Move> &moves, unsigned int &pn, unsigned int &dn);
+        void place_piece(Point &point, int curr_player);
+        void remove_piece(Point &point);
+        unsigned long long node_key(unsigned long long hash, int curr_player) const;
+        Entry lookup(unsigned long long key) const;
+        void store(unsigned long long key, unsigned int pn, unsigned int dn, const Point &best);
+        bool out_of_budget();
+
+        const int SIZE = 15;
+        const unsigned int INF = 100000000; //proof and disproof numbers never get bigger
+        ChessBoard board;
+        ThreatDetector threat_detector;
+        int attacker;
+        //pieces within 2 of every cell, an empty cell with any is a possible move
+        std::vector<std::vector<int>> neighbours;
+        //bounded, a new entry always replaces the old one in its slot
+        std::vector<Entry> table;
+        //search limits, 0 means no limit
+        long long nodes;
+        long long node_limit;
+        int time_limit; //ms
+        std::chrono::steady_clock::time_point start_time;
+        bool stopped;
+};
+
+//my_player --solve <positions> [--nodes N] [--time ms], positions are written like the state file
+int run_solve(int argc, char **argv);
+
+#endif
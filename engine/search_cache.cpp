@@ -0,0 +1,202 @@
+#include "search_cache.h"
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+SearchCache *SearchCache::shared(uint64_t inputs){
+    //every Engine of the process uses the same mapping, they all load the same weights
+    static std::unique_ptr<SearchCache> cache = [inputs](){
+        std::unique_ptr<SearchCache> cache;
+        const char *path = std::getenv(CACHE_ENV);
+        if(path != nullptr && path[0] != '\0'){
+            cache.reset(new SearchCache());
+            if(!cache->open(path, CACHE_ENTRIES, inputs)){
+                std::cerr << "can't map the search cache " << path << ", searching without it" << std::endl;
+                cache.reset();
+            }
+        }
+        return cache;
+    }();
+    return cache.get();
+}
+
+SearchCache::~SearchCache(){
+    close();
+}
+
+#ifdef _WIN32
+bool SearchCache::open(const std::string &, uint64_t, uint64_t){
+    //no mmap, the cache is always off on windows
+    return false;
+}
+
+bool SearchCache::open_memory(uint64_t){
+    return false;
+}
+
+void SearchCache::close(){}
+#else
+bool SearchCache::open(const std::string &path, uint64_t entry_number, uint64_t inputs){
+    //entry_number must be a power of 2
+    //other processes may have the file mapped, so a file that doesn't fit is never resized or cleared
+    //a new one is built next to it and renamed into place, the old mappings keep the old file
+    close();
+    size_t size = sizeof(Header) + entry_number*sizeof(CacheEntry);
+    int fd = -1;
+    while(true){
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if(fd < 0) return false;
+        //only one process gets the file ready at a time
+        if(flock(fd, LOCK_EX) != 0){
+            ::close(fd);
+            return false;
+        }
+        //another process may have renamed a new file into place while this one waited
+        struct stat file_stat, path_stat;
+        if(fstat(fd, &file_stat) == 0 && stat(path.c_str(), &path_stat) == 0 &&
+           file_stat.st_dev == path_stat.st_dev && file_stat.st_ino == path_stat.st_ino){
+            break;
+        }
+        ::close(fd);
+    }
+
+    struct stat file_stat;
+    void *mapped = MAP_FAILED;
+    bool created = false;
+    if(fstat(fd, &file_stat) == 0 && (size_t)file_stat.st_size == size){
+        mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    if(mapped != MAP_FAILED){
+        Header *old = (Header *)mapped;
+        bool valid = std::memcmp(old->magic, "GBTT", 4) == 0 && old->version == VERSION && old->entry_number == entry_number &&
+                     old->inputs == inputs && old->checksum == checksum(old, offsetof(Header, checksum));
+        if(!valid){
+            munmap(mapped, size);
+            mapped = MAP_FAILED;
+        }
+    }
+    if(mapped == MAP_FAILED){
+        //a new file, one of another size or one searched with other inputs
+        std::string new_path = path + "." + std::to_string(getpid());
+        int new_fd = ::open(new_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if(new_fd >= 0 && ftruncate(new_fd, size) == 0){
+            mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, new_fd, 0);
+        }
+        if(mapped != MAP_FAILED){
+            //a new file is all zeros
+            Header *fresh = (Header *)mapped;
+            std::memcpy(fresh->magic, "GBTT", 4);
+            fresh->version = VERSION;
+            fresh->entry_number = entry_number;
+            fresh->inputs = inputs;
+            //the first generation is set before anyone else can open it
+            fresh->generation = 1;
+            fresh->checksum = checksum(fresh, offsetof(Header, checksum));
+            created = true;
+            if(rename(new_path.c_str(), path.c_str()) != 0){
+                munmap(mapped, size);
+                mapped = MAP_FAILED;
+                created = false;
+            }
+        }
+        if(new_fd >= 0) ::close(new_fd);
+        if(mapped == MAP_FAILED) unlink(new_path.c_str());
+    }
+    if(mapped == MAP_FAILED){
+        ::close(fd);
+        return false;
+    }
+    memory = mapped;
+    memory_size = size;
+    header = (Header *)memory;
+    entries = (CacheEntry *)((char *)memory + sizeof(Header));
+    mask = entry_number - 1;
+
+    //entries of older generations are replaced first
+    if(created){
+        generation = (uint16_t)header->generation;
+    }
+    else{
+        generation = (uint16_t)__atomic_add_fetch(&header->generation, 1, __ATOMIC_SEQ_CST);
+        header->checksum = checksum(header, offsetof(Header, checksum));
+    }
+    //the mapping stays valid after closing the file, closing it lets the next process in
+    ::close(fd);
+    return true;
+}
+
+bool SearchCache::open_memory(uint64_t entry_number){
+    //entry_number must be a power of 2, anonymous memory starts as zeros so every entry fails its checksum
+    close();
+    size_t size = sizeof(Header) + entry_number*sizeof(CacheEntry);
+    void *mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(mapped == MAP_FAILED) return false;
+    memory = mapped;
+    memory_size = size;
+    header = (Header *)memory;
+    entries = (CacheEntry *)((char *)memory + sizeof(Header));
+    mask = entry_number - 1;
+    std::memcpy(header->magic, "GBTT", 4);
+    header->version = VERSION;
+    header->entry_number = entry_number;
+    header->generation = 1;
+    generation = 1;
+    return true;
+}
+
+void SearchCache::close(){
+    if(memory != nullptr){
+        munmap(memory, memory_size);
+    }
+    memory = nullptr;
+    header = nullptr;
+    entries = nullptr;
+}
+#endif
+
+bool SearchCache::probe(uint64_t key, CacheEntry &entry) const{
+    //copy first, another thread or process may be writing the slot
+    std::memcpy(&entry, &entries[key & mask], sizeof(CacheEntry));
+    return entry.key == key && entry.checksum == checksum(&entry, offsetof(CacheEntry, checksum));
+}
+
+void SearchCache::store(uint64_t key, float value, int depth, int bound, int x, int y){
+    //keep the deeper search of a position, but anything from an older generation or another position can go
+    CacheEntry old;
+    std::memcpy(&old, &entries[key & mask], sizeof(CacheEntry));
+    bool valid = old.checksum == checksum(&old, offsetof(CacheEntry, checksum));
+    if(valid && old.depth > depth && (old.key == key || old.generation == generation)){
+        return;
+    }
+    CacheEntry entry;
+    std::memset(&entry, 0, sizeof(entry));
+    entry.key = key;
+    entry.value = value;
+    entry.depth = (uint8_t)depth;
+    entry.bound = (uint8_t)bound;
+    entry.x = (int8_t)x;
+    entry.y = (int8_t)y;
+    entry.generation = generation;
+    entry.checksum = checksum(&entry, offsetof(CacheEntry, checksum));
+    std::memcpy(&entries[key & mask], &entry, sizeof(CacheEntry));
+}
+
+uint32_t SearchCache::checksum(const void *data, size_t size){
+    //fnv-1a
+    const unsigned char *bytes = (const unsigned char *)data;
+    uint32_t hash = 2166136261u;
+    for(size_t i = 0; i < size; i++){
+        hash = (hash ^ bytes[i])*16777619u;
+    }
+    return hash;
+}
@@ -0,0 +1,63 @@
+#ifndef GOBANG_SEARCH_CACHE_H
+#define GOBANG_SEARCH_CACHE_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "config.h"
+
+enum BOUND{
+    BOUND_EXACT = 0,
+    BOUND_LOWER = 1, //the value is at least this
+    BOUND_UPPER = 2, //the value is at most this
+};
+
+struct CacheEntry{
+    uint64_t key;
+    float value;
+    uint8_t depth; //plies searched below the position
+    uint8_t bound;
+    int8_t x; //best move, -1 if none
+    int8_t y;
+    uint16_t generation; //the open that wrote the entry
+    uint16_t unused;
+    uint32_t checksum; //of everything above, a torn or corrupt entry is never used
+};
+
+class SearchCache{
+    //transposition table in a memory mapped file so the next my_player process starts warm
+    //file: "GBTT", uint32 version, uint64 entry count, uint64 inputs, uint32 generation, uint32 header checksum, then the entries
+    //inputs is a hash of the weights and constants the values were searched with
+    //a file with another version, size or inputs is cleared, nothing else is ever trusted without its checksum
+    public:
+        //the cache of the file named by the CACHE_ENV environment variable, opened once per process with the inputs of the first call
+        //nullptr if the variable is not set or the file can't be mapped
+        static SearchCache *shared(uint64_t inputs);
+        ~SearchCache();
+        bool open(const std::string &path, uint64_t entry_number, uint64_t inputs);
+        //a cache only this process sees, for the threads of one process to share without a file
+        bool open_memory(uint64_t entry_number);
+        bool probe(uint64_t key, CacheEntry &entry) const;
+        void store(uint64_t key, float value, int depth, int bound, int x, int y);
+    private:
+        struct Header{
+            char magic[4];
+            uint32_t version;
+            uint64_t entry_number;
+            uint64_t inputs;
+            uint32_t generation;
+            uint32_t checksum;
+        };
+        static uint32_t checksum(const void *data, size_t size);
+        void close();
+        static const uint32_t VERSION = 3; //2: keys are canonical hashes, 3: inputs in the header
+        void *memory = nullptr;
+        size_t memory_size = 0;
+        Header *header = nullptr;
+        CacheEntry *entries = nullptr;
+        uint64_t mask = 0;
+        uint16_t generation = 0;
+};
+
+#endif
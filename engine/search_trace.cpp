@@ -0,0 +1,129 @@
+#include "search_trace.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+
+static const uint32_t TRACE_VERSION = 1;
+
+SearchTrace::SearchTrace(int thread, size_t capacity): thread{thread}, events(capacity), recorded{0}{
+    start = std::chrono::steady_clock::now();
+}
+
+void SearchTrace::clear(std::chrono::steady_clock::time_point start){
+    this->start = start;
+    recorded = 0;
+}
+
+void SearchTrace::record(int type, int ply, int depth, const Point &move, float alpha, float beta, float value, uint64_t time, uint32_t duration){
+    //the oldest event is overwritten when the buffer is full
+    TraceEvent &event = events[recorded % events.size()];
+    recorded++;
+    event.time = time;
+    event.alpha = alpha;
+    event.beta = beta;
+    event.value = value;
+    event.duration = duration;
+    event.type = (uint8_t)type;
+    event.thread = (uint8_t)thread;
+    event.ply = (uint8_t)ply;
+    event.depth = (uint8_t)depth;
+    event.x = (int8_t)move.x;
+    event.y = (int8_t)move.y;
+}
+
+uint64_t SearchTrace::elapsed() const{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+size_t SearchTrace::size() const{
+    return std::min<uint64_t>(recorded, events.size());
+}
+
+uint64_t SearchTrace::dropped() const{
+    return recorded - size();
+}
+
+const TraceEvent &SearchTrace::event(size_t i) const{
+    return events[(recorded - size() + i) % events.size()];
+}
+
+bool save_trace(const std::string &path, const std::vector<std::unique_ptr<SearchTrace>> &traces, size_t thread_number){
+    std::ofstream fout(path, std::ios::binary);
+    uint64_t count = 0, dropped = 0;
+    for(size_t t = 0; t < thread_number && t < traces.size(); t++){
+        count += traces[t]->size();
+        dropped += traces[t]->dropped();
+    }
+    uint32_t version = TRACE_VERSION;
+    fout.write("GBTR", 4);
+    fout.write((const char *)&version, sizeof(version));
+    fout.write((const char *)&count, sizeof(count));
+    fout.write((const char *)&dropped, sizeof(dropped));
+    for(size_t t = 0; t < thread_number && t < traces.size(); t++){
+        for(size_t i = 0; i < traces[t]->size(); i++){
+            fout.write((const char *)&traces[t]->event(i), sizeof(TraceEvent));
+        }
+    }
+    return (bool)fout;
+}
+
+int run_trace_json(int argc, char **argv){
+    //every node is a begin and end event named by its move, cutoffs are instant events and evaluations complete events
+    if(argc < 4){
+        std::cerr << "usage: " << argv[0] << " --trace-json <trace> <output>" << std::endl;
+        return 1;
+    }
+    std::ifstream fin(argv[2], std::ios::binary);
+    char magic[4];
+    uint32_t version;
+    uint64_t count, dropped;
+    if(!fin.read(magic, 4) || std::memcmp(magic, "GBTR", 4) != 0){
+        std::cerr << argv[2] << ": not a search trace" << std::endl;
+        return 1;
+    }
+    fin.read((char *)&version, sizeof(version));
+    fin.read((char *)&count, sizeof(count));
+    fin.read((char *)&dropped, sizeof(dropped));
+    if(!fin || version != TRACE_VERSION){
+        std::cerr << argv[2] << ": unsupported trace version" << std::endl;
+        return 1;
+    }
+
+    std::ofstream fout(argv[3]);
+    fout << "{\"displayTimeUnit\":\"ns\",\"otherData\":{\"dropped_events\":" << dropped << "},\"traceEvents\":[";
+    TraceEvent event;
+    uint64_t read = 0, written = 0;
+    std::map<int, int> open_nodes; //of every thread
+    while(read++ < count && fin.read((char *)&event, sizeof(event))){
+        if(event.type == TRACE_ENTER) open_nodes[event.thread]++;
+        if(event.type == TRACE_EXIT){
+            //the ring buffer may have dropped where the node started
+            if(open_nodes[event.thread] == 0) continue;
+            open_nodes[event.thread]--;
+        }
+        fout << (written++ ? ",\n" : "\n");
+        std::string name = "(" + std::to_string(event.x) + ", " + std::to_string(event.y) + ")";
+        if(event.ply == 0 && event.type != TRACE_CUTOFF) name = "root";
+        fout << "{\"pid\":1,\"tid\":" << (int)event.thread << ",\"ts\":" << event.time/1000.0;
+        if(event.type == TRACE_ENTER){
+            fout << ",\"ph\":\"B\",\"name\":\"" << name << "\",\"args\":{\"ply\":" << (int)event.ply << ",\"depth\":" << (int)event.depth
+                 << ",\"alpha\":" << event.alpha << ",\"beta\":" << event.beta << "}}";
+        }
+        else if(event.type == TRACE_EXIT){
+            fout << ",\"ph\":\"E\",\"args\":{\"value\":" << event.value << "}}";
+        }
+        else if(event.type == TRACE_CUTOFF){
+            fout << ",\"ph\":\"i\",\"s\":\"t\",\"name\":\"cutoff " << name << "\",\"args\":{\"ply\":" << (int)event.ply
+                 << ",\"alpha\":" << event.alpha << ",\"beta\":" << event.beta << ",\"value\":" << event.value << "}}";
+        }
+        else{
+            fout << ",\"ph\":\"X\",\"name\":\"evaluate\",\"dur\":" << event.duration/1000.0 << ",\"args\":{\"value\":" << event.value << "}}";
+        }
+    }
+    fout << "\n]}" << std::endl;
+    std::cout << written << " events, " << dropped << " dropped" << std::endl;
+    return fout ? 0 : 1;
+}
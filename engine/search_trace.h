@@ -0,0 +1,59 @@
+#ifndef GOBANG_SEARCH_TRACE_H
+#define GOBANG_SEARCH_TRACE_H
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "config.h"
+#include "point.h"
+
+enum TRACE_EVENT{
+    TRACE_ENTER = 0, //alpha and beta the node is searched with
+    TRACE_EXIT = 1, //value of the node
+    TRACE_CUTOFF = 2, //move is the child that caused it, value its value
+    TRACE_EVAL = 3, //time is the start of the evaluation, duration how long it took
+};
+
+struct TraceEvent{
+    uint64_t time; //ns since the search started
+    float alpha;
+    float beta;
+    float value;
+    uint32_t duration; //ns
+    uint8_t type;
+    uint8_t thread;
+    uint8_t ply;
+    uint8_t depth; //plies left to search
+    int8_t x; //move that led to the node, -1 if none
+    int8_t y;
+    uint8_t unused[2];
+};
+
+class SearchTrace{
+    //the last events of one thread's search, nothing is allocated while searching
+    public:
+        SearchTrace(int thread, size_t capacity);
+        void clear(std::chrono::steady_clock::time_point start);
+        //time is elapsed() when the event happened, the start for events with a duration
+        void record(int type, int ply, int depth, const Point &move, float alpha, float beta, float value, uint64_t time, uint32_t duration = 0);
+        uint64_t elapsed() const;
+        size_t size() const;
+        uint64_t dropped() const;
+        const TraceEvent &event(size_t i) const; //oldest first
+    private:
+        int thread;
+        std::vector<TraceEvent> events; //ring buffer
+        uint64_t recorded;
+        std::chrono::steady_clock::time_point start;
+};
+
+//file: "GBTR", uint32 version, uint64 event count, uint64 dropped events, then the events of every thread in order
+bool save_trace(const std::string &path, const std::vector<std::unique_ptr<SearchTrace>> &traces, size_t thread_number);
+
+//my_player --trace-json <trace> <output>, writes the chrome trace event format (chrome://tracing, perfetto, speedscope)
+int run_trace_json(int argc, char **argv);
+
+#endif
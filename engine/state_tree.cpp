@@ -0,0 +1,8 @@
+#include "state_tree.h"
+
+StateTreeNode::StateTreeNode(): value{0}, score{0} {};
+
+StateTreeNode::StateTreeNode(int player):player{player}, value{0}, parent{nullptr}, score{0}{}
+
+StateTreeNode::StateTreeNode(Point placement, int player, StateTreeNode *parent):
+placement{placement}, player{player}, value{0}, parent{parent}, score{0} {}
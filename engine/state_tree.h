@@ -0,0 +1,27 @@
+#ifndef GOBANG_STATE_TREE_H
+#define GOBANG_STATE_TREE_H
+
+#include <vector>
+
+#include "point.h"
+
+class StateTreeNode{
+    public:
+        StateTreeNode();
+        StateTreeNode(int player);
+        StateTreeNode(Point placement, int player, StateTreeNode *parent);
+
+        friend class DecisionMaker;
+    private: 
+        int player;
+        float value;
+        Point placement;
+        StateTreeNode *parent;
+        std::vector<StateTreeNode> childs;
+        //move ordering information of placement
+        float score;
+        int attack; //situation the placement creates for the one who moves
+        int defence; //situation the placement takes away from the other one
+};
+
+#endif
@@ -0,0 +1,103 @@
+#include "threat_detector.h"
+
+#include <algorithm>
+
+ThreatDetector::ThreatDetector(int size): SIZE{size}{
+    threat_scores[WIN5] = 100000.0;
+    threat_scores[LIVE4] = 10000.0;
+    threat_scores[OPEN4] = 1400.0;
+    threat_scores[LIVE3] = 1000.0;
+    threat_scores[OPEN3] = 400.0;
+    threat_scores[SELF2] = 100.0;
+    threat_scores[ENEMY2] = 0.0;
+    threat_scores[NO_SITUATION] = 0.0;
+}
+
+int ThreatDetector::move_situation(const std::vector<std::vector<int>> &board, int x, int y, int player) const{
+    //the best line situation, two strong lines together are as good as a live four
+    int fours = 0;
+    int threes = 0;
+    int best = NO_SITUATION;
+    const int dx[4] = {1, 0, 1, 1};
+    const int dy[4] = {0, 1, 1, -1};
+    for(int i = 0; i < 4; i++){
+        int situation = line_situation(board, x, y, dx[i], dy[i], player);
+        if(situation == OPEN4) fours++;
+        if(situation == LIVE3) threes++;
+        best = std::min(best, situation);
+    }
+    if(best > LIVE4 && (fours >= 2 || (fours == 1 && threes >= 1))){
+        //double four and four three can't be blocked with one move
+        best = LIVE4;
+    }
+    else if(best > OPEN4 && threes >= 2){
+        best = OPEN4;
+    }
+    return best;
+}
+
+int ThreatDetector::line_situation(const std::vector<std::vector<int>> &board, int x, int y, int dx, int dy, int player) const{
+    //cells 4 away on both sides, the placement is at line[4]
+    //1: own piece, 0: empty, -1: enemy piece or out of the board
+    int line[9];
+    for(int i = -4; i <= 4; i++){
+        int cx = x + i*dx;
+        int cy = y + i*dy;
+        if(i == 0){
+            line[i+4] = 1;
+        }
+        else if(cx < 0 || cx >= SIZE || cy < 0 || cy >= SIZE){
+            line[i+4] = -1;
+        }
+        else if(board[cx][cy] == 0){
+            line[i+4] = 0;
+        }
+        else{
+            line[i+4] = (board[cx][cy] == player) ? 1:-1;
+        }
+    }
+
+    //look at every 5 cell window that contains the placement
+    int completions = 0; //bitmask of the empty cells that make a five
+    int best = NO_SITUATION;
+    for(int start = 0; start <= 4; start++){
+        int own = 0, empty = 0, empty_at = -1;
+        for(int i = start; i < start+5; i++){
+            if(line[i] == 1) own++;
+            else if(line[i] == 0){
+                empty++;
+                empty_at = i;
+            }
+        }
+        if(own == 5) return WIN5;
+        if(own + empty < 5) continue;
+        if(own == 4) completions |= 1 << empty_at;
+        else if(own == 3) best = std::min(best, (int)OPEN3);
+        else if(own == 2) best = std::min(best, (int)SELF2);
+    }
+    if(completions != 0){
+        //two different cells to finish the five can't be both blocked
+        return (completions & (completions-1)) ? LIVE4:OPEN4;
+    }
+
+    //live three : .OOO. or .O.OO. with both ends empty
+    for(int start = 0; start <= 3; start++){
+        if(line[start] != 0 || line[start+5] != 0) continue;
+        int own = 0, empty = 0;
+        for(int i = start+1; i <= start+4; i++){
+            if(line[i] == 1) own++;
+            else if(line[i] == 0) empty++;
+        }
+        if(own == 3 && empty == 1) return LIVE3;
+    }
+    return best;
+}
+
+float ThreatDetector::situation_score(int situation) const{
+    return threat_scores.at(situation);
+}
+
+bool ThreatDetector::is_tactical(int situation) const{
+    //fours and threes must be answered, never skip or reduce them
+    return situation <= LIVE3;
+}
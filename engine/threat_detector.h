@@ -0,0 +1,23 @@
+#ifndef GOBANG_THREAT_DETECTOR_H
+#define GOBANG_THREAT_DETECTOR_H
+
+#include <map>
+#include <vector>
+
+#include "evaluator.h"
+
+class ThreatDetector{
+    //find the situation a single placement creates, only looks at the 4 lines through it
+    public:
+        ThreatDetector() {};
+        ThreatDetector(int size);
+        int move_situation(const std::vector<std::vector<int>> &board, int x, int y, int player) const;
+        float situation_score(int situation) const;
+        bool is_tactical(int situation) const;
+    private:
+        int line_situation(const std::vector<std::vector<int>> &board, int x, int y, int dx, int dy, int player) const;
+        int SIZE;
+        std::map<int, float> threat_scores;
+};
+
+#endif
@@ -0,0 +1,444 @@
+#include "weight_tuner.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <thread>
+
+WeightTuner::WeightTuner(int thread_number): thread_number{thread_number}, k{1000.0}{
+    evaluator = Evaluator(SIZE, 1);
+    evaluator.load_weights(WEIGHTS_FILE);
+}
+
+int WeightTuner::load_game_log(const std::string &path){
+    //reads the gamelog.txt written by main, a file may hold many games one after another
+    return read_game_log(path, positions, results);
+}
+
+int WeightTuner::load_corpus(const std::string &path){
+    //only the positions with a label
+    CorpusReader corpus;
+    if(!corpus.open(path)) return 0;
+    int loaded = 0;
+    for(size_t i = 0; i < corpus.size(); i++){
+        if(!(corpus[i].flags & CORPUS_LABEL)) continue;
+        positions.push_back(std::make_pair((int)corpus[i].player, decode_board(corpus[i])));
+        results.push_back((corpus[i].label + 1)/2.0f);
+        loaded++;
+    }
+    return loaded;
+}
+
+void WeightTuner::extract_features(){
+    //counting the situations is the slow part, it is only done once for every position
+    size_t n = positions.size();
+    own_features = std::vector<std::vector<float>>(WEIGHT_NUMBER, std::vector<float>(n));
+    enemy_features = std::vector<std::vector<float>>(WEIGHT_NUMBER, std::vector<float>(n));
+    std::atomic<size_t> next_position(0);
+    auto worker = [&](){
+        Evaluator local_evaluator = evaluator;
+        for(size_t i = next_position++; i < n; i = next_position++){
+            local_evaluator.count_situations(positions[i].second.board);
+            PlayerScore &own = (positions[i].first == 1) ? local_evaluator.player1_score : local_evaluator.player2_score;
+            PlayerScore &enemy = (positions[i].first == 1) ? local_evaluator.player2_score : local_evaluator.player1_score;
+            for(int j = 0; j < WEIGHT_NUMBER; j++){
+                own_features[j][i] = own.situation_occurence[j+1];
+                enemy_features[j][i] = enemy.situation_occurence[j+1];
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    for(int i = 0; i < thread_number; i++){
+        threads.push_back(std::thread(worker));
+    }
+    for(auto &thread:threads){
+        thread.join();
+    }
+    //boards are not needed anymore
+    std::vector<std::pair<int, ChessBoard>>().swap(positions);
+}
+
+void WeightTuner::gradient(int begin, int end, float k, const std::vector<float> &weights, float multiplier, std::vector<double> &result) const{
+    //result is the squared error followed by its derivative for every weight and the multiplier
+    std::vector<float> score(end - begin, 0.0);
+    std::vector<float> enemy_score(end - begin, 0.0);
+    for(int j = 0; j < WEIGHT_NUMBER; j++){
+        const float *own = &own_features[j][begin];
+        const float *enemy = &enemy_features[j][begin];
+        float w = weights[j];
+        for(int i = 0; i < end - begin; i++){
+            score[i] += w*own[i];
+            enemy_score[i] += w*enemy[i];
+        }
+    }
+    //d(error)/d(score) of every position
+    std::vector<float> slope(end - begin);
+    double error = 0;
+    for(int i = 0; i < end - begin; i++){
+        float p = 1.0f/(1.0f + std::exp(-(score[i] - multiplier*enemy_score[i])/k));
+        float diff = results[begin + i] - p;
+        error += diff*diff;
+        slope[i] = -2.0f*diff*p*(1.0f - p)/k;
+    }
+    result.assign(WEIGHT_NUMBER + 2, 0.0);
+    result[0] = error;
+    for(int j = 0; j < WEIGHT_NUMBER; j++){
+        const float *own = &own_features[j][begin];
+        const float *enemy = &enemy_features[j][begin];
+        float sum = 0;
+        for(int i = 0; i < end - begin; i++){
+            sum += slope[i]*(own[i] - multiplier*enemy[i]);
+        }
+        result[j+1] = sum;
+    }
+    float sum = 0;
+    for(int i = 0; i < end - begin; i++){
+        sum -= slope[i]*enemy_score[i];
+    }
+    result[WEIGHT_NUMBER+1] = sum;
+}
+
+float WeightTuner::loss(float k, const std::vector<float> &weights, float multiplier) const{
+    std::vector<double> result;
+    gradient(0, results.size(), k, weights, multiplier, result);
+    return result[0]/results.size();
+}
+
+void WeightTuner::fit(int epochs){
+    size_t n = results.size();
+    if(n == 0) return;
+    std::vector<float> weights;
+    for(int j = 0; j < WEIGHT_NUMBER; j++){
+        weights.push_back(evaluator.situation_scores[j+1]);
+    }
+    float multiplier = evaluator.enemy_score_multiplier;
+
+    //pick K that fits the starting weights best, so only the weights change how the scores are read
+    float low = std::log(10.0f), high = std::log(100000.0f);
+    for(int i = 0; i < 40; i++){
+        float a = low + (high - low)/3, b = high - (high - low)/3;
+        if(loss(std::exp(a), weights, multiplier) < loss(std::exp(b), weights, multiplier)) high = b;
+        else low = a;
+    }
+    k = std::exp((low + high)/2);
+    std::cout << "positions: " << n << " K: " << k << " starting loss: " << loss(k, weights, multiplier) << std::endl;
+
+    //adam, every step is a fraction of the starting size of the weight
+    std::vector<float> step_size;
+    for(int j = 0; j < WEIGHT_NUMBER; j++){
+        step_size.push_back(0.01f*std::max(1.0f, std::abs(weights[j])));
+    }
+    step_size.push_back(0.005f);
+    std::vector<double> m(WEIGHT_NUMBER + 1, 0.0), v(WEIGHT_NUMBER + 1, 0.0);
+    const double beta1 = 0.9, beta2 = 0.999;
+
+    size_t chunk = (n + thread_number - 1)/thread_number;
+    std::vector<std::vector<double>> partial(thread_number);
+    for(int epoch = 1; epoch <= epochs; epoch++){
+        std::vector<std::thread> threads;
+        for(int t = 0; t < thread_number; t++){
+            int begin = std::min(n, t*chunk), end = std::min(n, (t+1)*chunk);
+            threads.push_back(std::thread(&WeightTuner::gradient, this, begin, end, k, std::cref(weights), multiplier, std::ref(partial[t])));
+        }
+        for(auto &thread:threads){
+            thread.join();
+        }
+        std::vector<double> total(WEIGHT_NUMBER + 2, 0.0);
+        for(auto &result:partial){
+            for(int j = 0; j < WEIGHT_NUMBER + 2; j++){
+                total[j] += result[j];
+            }
+        }
+
+        for(int j = 0; j <= WEIGHT_NUMBER; j++){
+            double g = total[j+1]/n;
+            m[j] = beta1*m[j] + (1 - beta1)*g;
+            v[j] = beta2*v[j] + (1 - beta2)*g*g;
+            double m_hat = m[j]/(1 - std::pow(beta1, epoch));
+            double v_hat = v[j]/(1 - std::pow(beta2, epoch));
+            float step = step_size[j]*m_hat/(std::sqrt(v_hat) + 1e-12);
+            if(j < WEIGHT_NUMBER) weights[j] = std::max(0.0f, weights[j] - step);
+            else multiplier = std::max(0.0f, multiplier - step);
+        }
+        if(epoch % 100 == 0 || epoch == epochs){
+            std::cout << "epoch " << epoch << " loss: " << total[0]/n << std::endl;
+        }
+    }
+
+    for(int j = 0; j < WEIGHT_NUMBER; j++){
+        evaluator.situation_scores[j+1] = weights[j];
+    }
+    evaluator.enemy_score_multiplier = multiplier;
+}
+
+bool WeightTuner::save_weights(const std::string &path) const{
+    return evaluator.save_weights(path);
+}
+
+// ----- Network Tuner ----- //
+
+NetworkTuner::NetworkTuner(int thread_number): thread_number{thread_number}, k{1000.0}{
+    offsets.push_back(0);
+    std::unique_ptr<PatternWeights> start(new PatternWeights());
+    if(!start->load(PATTERN_WEIGHTS_FILE)){
+        start->init_window_scores();
+    }
+    //the output divisor is folded into the output weights, save picks a new one
+    parameters.assign(PARAMETER_NUMBER, 0.0f);
+    for(int i = 0; i < PATTERN_HIDDEN; i++){
+        parameters[i] = start->bias[i];
+        parameters[OUTPUT + i] = (float)start->output[i]/start->output_divisor;
+    }
+    for(int f = 0; f < FEATURE_NUMBER; f++){
+        const int16_t *weight = start->windows[f/PatternWeights::PATTERN_NUMBER][f%PatternWeights::PATTERN_NUMBER];
+        for(int i = 0; i < PATTERN_HIDDEN; i++){
+            parameters[WINDOWS + f*PATTERN_HIDDEN + i] = weight[i];
+        }
+    }
+    parameters[OUTPUT_BIAS] = (float)start->output_bias/start->output_divisor;
+}
+
+int NetworkTuner::load_game_log(const std::string &path){
+    std::vector<std::pair<int, ChessBoard>> positions;
+    std::vector<float> position_results;
+    int loaded = read_game_log(path, positions, position_results);
+    for(size_t i = 0; i < positions.size(); i++){
+        add_position(positions[i].first, positions[i].second, position_results[i]);
+    }
+    return loaded;
+}
+
+int NetworkTuner::load_corpus(const std::string &path){
+    //only the positions with a label
+    CorpusReader corpus;
+    if(!corpus.open(path)) return 0;
+    int loaded = 0;
+    for(size_t i = 0; i < corpus.size(); i++){
+        if(!(corpus[i].flags & CORPUS_LABEL)) continue;
+        add_position(corpus[i].player, decode_board(corpus[i]), (corpus[i].label + 1)/2.0f);
+        loaded++;
+    }
+    return loaded;
+}
+
+void NetworkTuner::add_position(int player, const ChessBoard &board, float result){
+    //the windows are counted like PatternNetwork::refresh, the empty ones too
+    const int dx[4] = {1, 0, 1, 1};
+    const int dy[4] = {0, 1, 1, -1};
+    const int power[5] = {1, 3, 9, 27, 81};
+    std::vector<uint16_t> counts(FEATURE_NUMBER, 0);
+    for(int d = 0; d < 4; d++){
+        for(int x = 0; x < SIZE; x++){
+            for(int y = 0; y < SIZE; y++){
+                int ex = x + 4*dx[d], ey = y + 4*dy[d];
+                if(ex < 0 || ex >= SIZE || ey < 0 || ey >= SIZE) continue;
+                int pattern = 0;
+                for(int i = 0; i < 5; i++){
+                    pattern += board[x + i*dx[d]][y + i*dy[d]]*power[i];
+                }
+                counts[d*PatternWeights::PATTERN_NUMBER + pattern]++;
+            }
+        }
+    }
+    for(int f = 0; f < FEATURE_NUMBER; f++){
+        if(counts[f] != 0) features.push_back(Feature{(uint16_t)f, counts[f]});
+    }
+    offsets.push_back(features.size());
+    signs.push_back(player == 1 ? 1.0f : -1.0f);
+    results.push_back(result);
+}
+
+float NetworkTuner::score(size_t position, float *hidden) const{
+    //the score for the one to move, hidden gets the accumulator before the clipping
+    for(int i = 0; i < PATTERN_HIDDEN; i++){
+        hidden[i] = parameters[i];
+    }
+    for(size_t j = offsets[position]; j < offsets[position+1]; j++){
+        const float *weight = &parameters[WINDOWS + features[j].index*PATTERN_HIDDEN];
+        float count = features[j].count;
+        for(int i = 0; i < PATTERN_HIDDEN; i++){
+            hidden[i] += count*weight[i];
+        }
+    }
+    float sum = parameters[OUTPUT_BIAS];
+    for(int i = 0; i < PATTERN_HIDDEN; i++){
+        sum += std::min(std::max(hidden[i], 0.0f), 127.0f)*parameters[OUTPUT + i];
+    }
+    return signs[position]*sum;
+}
+
+void NetworkTuner::gradient(size_t begin, size_t end, std::vector<double> &result) const{
+    //result is the squared error followed by its derivative for every parameter
+    result.assign(PARAMETER_NUMBER + 1, 0.0);
+    double *slopes = &result[1];
+    float hidden[PATTERN_HIDDEN];
+    for(size_t n = begin; n < end; n++){
+        float p = 1.0f/(1.0f + std::exp(-score(n, hidden)/k));
+        float diff = results[n] - p;
+        result[0] += diff*diff;
+        //d(error)/d(sum) of the network output for black
+        float slope = -2.0f*diff*p*(1.0f - p)/k*signs[n];
+        float hidden_slope[PATTERN_HIDDEN];
+        for(int i = 0; i < PATTERN_HIDDEN; i++){
+            bool active = hidden[i] > 0.0f && hidden[i] < 127.0f;
+            slopes[OUTPUT + i] += slope*std::min(std::max(hidden[i], 0.0f), 127.0f);
+            hidden_slope[i] = active ? slope*parameters[OUTPUT + i] : 0.0f;
+            slopes[i] += hidden_slope[i];
+        }
+        slopes[OUTPUT_BIAS] += slope;
+        for(size_t j = offsets[n]; j < offsets[n+1]; j++){
+            double *weight_slope = &slopes[WINDOWS + features[j].index*PATTERN_HIDDEN];
+            float count = features[j].count;
+            for(int i = 0; i < PATTERN_HIDDEN; i++){
+                weight_slope[i] += count*hidden_slope[i];
+            }
+        }
+    }
+}
+
+void NetworkTuner::fit(int epochs){
+    size_t n = results.size();
+    if(n == 0) return;
+
+    //pick K that fits the starting network best
+    std::vector<float> scores(n);
+    float hidden[PATTERN_HIDDEN];
+    for(size_t i = 0; i < n; i++){
+        scores[i] = score(i, hidden);
+    }
+    auto loss = [&](float k){
+        double error = 0;
+        for(size_t i = 0; i < n; i++){
+            float diff = results[i] - 1.0f/(1.0f + std::exp(-scores[i]/k));
+            error += diff*diff;
+        }
+        return error/n;
+    };
+    float low = std::log(10.0f), high = std::log(1e8f);
+    for(int i = 0; i < 60; i++){
+        float a = low + (high - low)/3, b = high - (high - low)/3;
+        if(loss(std::exp(a)) < loss(std::exp(b))) high = b;
+        else low = a;
+    }
+    k = std::exp((low + high)/2);
+    std::cout << "positions: " << n << " K: " << k << " starting loss: " << loss(k) << std::endl;
+
+    //adam, the hidden units are clipped at 127 so the window weights and biases move about one at a time
+    std::vector<float> step_size(PARAMETER_NUMBER, 0.5f);
+    for(int i = 0; i < PATTERN_HIDDEN; i++){
+        step_size[OUTPUT + i] = 0.01f*std::max(1.0f, std::abs(parameters[OUTPUT + i]));
+    }
+    step_size[OUTPUT_BIAS] = 0.01f*k;
+    std::vector<double> m(PARAMETER_NUMBER, 0.0), v(PARAMETER_NUMBER, 0.0);
+    const double beta1 = 0.9, beta2 = 0.999;
+
+    size_t chunk = (n + thread_number - 1)/thread_number;
+    std::vector<std::vector<double>> partial(thread_number);
+    for(int epoch = 1; epoch <= epochs; epoch++){
+        std::vector<std::thread> threads;
+        for(int t = 0; t < thread_number; t++){
+            size_t begin = std::min(n, t*chunk), end = std::min(n, (t+1)*chunk);
+            threads.push_back(std::thread(&NetworkTuner::gradient, this, begin, end, std::ref(partial[t])));
+        }
+        for(auto &thread:threads){
+            thread.join();
+        }
+        std::vector<double> total(PARAMETER_NUMBER + 1, 0.0);
+        for(auto &result:partial){
+            for(int j = 0; j <= PARAMETER_NUMBER; j++){
+                total[j] += result[j];
+            }
+        }
+
+        for(int j = 0; j < PARAMETER_NUMBER; j++){
+            double g = total[j+1]/n;
+            if(g == 0 && m[j] == 0) continue; //windows that never show up
+            m[j] = beta1*m[j] + (1 - beta1)*g;
+            v[j] = beta2*v[j] + (1 - beta2)*g*g;
+            double m_hat = m[j]/(1 - std::pow(beta1, epoch));
+            double v_hat = v[j]/(1 - std::pow(beta2, epoch));
+            parameters[j] -= step_size[j]*m_hat/(std::sqrt(v_hat) + 1e-12);
+            //the file keeps 16 bit weights
+            if(j < OUTPUT) parameters[j] = std::min(std::max(parameters[j], -32767.0f), 32767.0f);
+        }
+        if(epoch % 10 == 0 || epoch == epochs){
+            std::cout << "epoch " << epoch << " loss: " << total[0]/n << std::endl;
+        }
+    }
+}
+
+bool NetworkTuner::save_weights(const std::string &path) const{
+    //the output weights are scaled up as far as 16 bits allow and the divisor takes the scale back out
+    std::unique_ptr<PatternWeights> weights(new PatternWeights());
+    float largest = 1e-6f;
+    for(int i = 0; i < PATTERN_HIDDEN; i++){
+        largest = std::max(largest, std::abs(parameters[OUTPUT + i]));
+    }
+    int32_t scale = (int32_t)std::min(1024.0f, std::max(1.0f, 32767.0f/largest));
+    auto round16 = [](float value){
+        return (int16_t)std::lround(std::min(std::max(value, -32767.0f), 32767.0f));
+    };
+    for(int i = 0; i < PATTERN_HIDDEN; i++){
+        weights->bias[i] = round16(parameters[i]);
+        weights->output[i] = round16(parameters[OUTPUT + i]*scale);
+    }
+    for(int f = 0; f < FEATURE_NUMBER; f++){
+        int16_t *weight = weights->windows[f/PatternWeights::PATTERN_NUMBER][f%PatternWeights::PATTERN_NUMBER];
+        for(int i = 0; i < PATTERN_HIDDEN; i++){
+            weight[i] = round16(parameters[WINDOWS + f*PATTERN_HIDDEN + i]);
+        }
+    }
+    weights->output_bias = (int32_t)std::lround(parameters[OUTPUT_BIAS]*scale);
+    weights->output_divisor = scale;
+    return weights->save(path);
+}
+
+int run_tune(int argc, char **argv){
+    if(argc < 4){
+        std::cerr << "usage: " << argv[0] << " --tune <weights output> <game logs or corpora...> [--threads N] [--epochs N] [--network]" << std::endl;
+        return 1;
+    }
+    int thread_number = std::max(1u, std::thread::hardware_concurrency());
+    int epochs = 0;
+    bool network = false;
+    std::vector<std::string> logs;
+    for(int i = 3; i < argc; i++){
+        std::string option = argv[i];
+        if(option == "--threads" && i + 1 < argc) thread_number = std::max(1, atoi(argv[++i]));
+        else if(option == "--epochs" && i + 1 < argc) epochs = atoi(argv[++i]);
+        else if(option == "--network") network = true;
+        else logs.push_back(option);
+    }
+
+    if(network){
+        //every epoch goes over all the windows of every position, fewer are needed than for the evaluator
+        NetworkTuner tuner(thread_number);
+        for(auto &log:logs){
+            int loaded = CorpusReader::is_corpus(log) ? tuner.load_corpus(log) : tuner.load_game_log(log);
+            std::cout << log << ": " << loaded << " positions" << std::endl;
+        }
+        tuner.fit(epochs > 0 ? epochs : 100);
+        if(!tuner.save_weights(argv[2])){
+            std::cerr << "can't write " << argv[2] << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    WeightTuner tuner(thread_number);
+    for(auto &log:logs){
+        int loaded = CorpusReader::is_corpus(log) ? tuner.load_corpus(log) : tuner.load_game_log(log);
+        std::cout << log << ": " << loaded << " positions" << std::endl;
+    }
+    tuner.extract_features();
+    tuner.fit(epochs > 0 ? epochs : 1000);
+    if(!tuner.save_weights(argv[2])){
+        std::cerr << "can't write " << argv[2] << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,80 @@
+#ifndef GOBANG_WEIGHT_TUNER_H
+#define GOBANG_WEIGHT_TUNER_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "chess_board.h"
+#include "evaluator.h"
+#include "pattern_network.h"
+#include "position_corpus.h"
+
+class WeightTuner{
+    //fit the evaluator weights to game results (texel tuning)
+    //the score of a position is turned into a win probability with sigmoid(score/K)
+    //and the weights are moved to make it closer to the result of the game
+    public:
+        WeightTuner(int thread_number);
+        int load_game_log(const std::string &path);
+        int load_corpus(const std::string &path);
+        void extract_features();
+        void fit(int epochs);
+        bool save_weights(const std::string &path) const;
+    private:
+        //weights that are tuned, WIN5 only shows up when the game is over so it is kept
+        static const int WEIGHT_NUMBER = SITUAION_NUMBER - 1;
+        float loss(float k, const std::vector<float> &weights, float multiplier) const;
+        void gradient(int begin, int end, float k, const std::vector<float> &weights, float multiplier, std::vector<double> &result) const;
+        const int SIZE = 15;
+        int thread_number;
+        Evaluator evaluator;
+        //positions from the game logs, player is the one to move
+        std::vector<std::pair<int, ChessBoard>> positions;
+        std::vector<float> results; //1 win, 0.5 draw, 0 lose for the one to move
+        //feature i of position n is at features[i][n] so the loops over positions vectorize
+        std::vector<std::vector<float>> own_features;
+        std::vector<std::vector<float>> enemy_features;
+        float k;
+};
+
+class NetworkTuner{
+    //fit the pattern network to game results with the same loss as WeightTuner
+    //the network is trained in floats starting from PATTERN_WEIGHTS_FILE (or the window scores) and rounded when saved
+    public:
+        NetworkTuner(int thread_number);
+        int load_game_log(const std::string &path);
+        int load_corpus(const std::string &path);
+        void fit(int epochs);
+        bool save_weights(const std::string &path) const;
+    private:
+        static const int FEATURE_NUMBER = 4*PatternWeights::PATTERN_NUMBER;
+        //the parameters in one vector: hidden bias, windows (feature f is at WINDOWS + f*PATTERN_HIDDEN), output, output bias
+        static const int WINDOWS = PATTERN_HIDDEN;
+        static const int OUTPUT = WINDOWS + FEATURE_NUMBER*PATTERN_HIDDEN;
+        static const int OUTPUT_BIAS = OUTPUT + PATTERN_HIDDEN;
+        static const int PARAMETER_NUMBER = OUTPUT_BIAS + 1;
+        struct Feature{
+            uint16_t index; //direction*243 + pattern
+            uint16_t count; //windows of the board with it
+        };
+        void add_position(int player, const ChessBoard &board, float result);
+        float score(size_t position, float *hidden) const;
+        void gradient(size_t begin, size_t end, std::vector<double> &result) const;
+        const int SIZE = 15;
+        int thread_number;
+        //the features of position n are features[offsets[n]] to features[offsets[n+1]]
+        std::vector<Feature> features;
+        std::vector<size_t> offsets;
+        std::vector<float> signs; //1 if black is to move, the network scores for black
+        std::vector<float> results; //1 win, 0.5 draw, 0 lose for the one to move
+        std::vector<float> parameters;
+        float k;
+};
+
+//my_player --tune <weights output> <game logs or corpora...> [--threads N] [--epochs N] [--network]
+//--network fits the pattern network and writes it instead of the evaluator weights
+int run_tune(int argc, char **argv);
+
+#endif
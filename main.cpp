@@ -5,6 +5,14 @@
 #include <array>
 #include <vector>
 #include <cassert>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
+#define NOMINMAX
+#include <windows.h>
+#endif
 
 #define TIMEOUT 50
 
@@ -158,12 +166,16 @@ public:
         if (board[x][y] == WHITE) return "X";
         return " ";
     }
-    std::string encode_output(bool fail=false) {
+    void lose_on_time() {
+        winner = get_next_player(cur_player);
+        done = true;
+    }
+    std::string encode_output(bool fail=false, std::string reason="Opponent performed invalid move") {
         int i, j;
         std::stringstream ss;
         ss << "Timestep #" << (SIZE*SIZE-empty_count+1) << "\n";
         if (fail) {
-            ss << "Winner is " << encode_player(winner) << " (Opponent performed invalid move)\n";
+            ss << "Winner is " << encode_player(winner) << " (" << reason << ")\n";
         } else if (done) {
             ss << "Winner is " << encode_player(winner) << "\n";
         } else {
@@ -199,34 +211,95 @@ const std::string file_state = "state";
 const std::string file_action = "action";
 const int timeout = TIMEOUT;
 
-void launch_executable(std::string filename) {
+// Time control of a game, all in seconds.
+// The player is killed after move_time or after the rest of its game time, whichever is first.
+struct TimeControl {
+    double move_time = timeout;
+    double game_time = 0; // 0: no limit for the whole game
+    double increment = 0; // added to the game time after every move (Fischer)
+};
+
+class PlayerClock {
+public:
+    double remaining; // seconds left for the whole game
+    std::vector<double> latencies; // seconds taken by every move
+    PlayerClock() : remaining(0) {}
+    double percentile(double p) const {
+        if (latencies.empty())
+            return 0;
+        std::vector<double> sorted = latencies;
+        std::sort(sorted.begin(), sorted.end());
+        size_t rank = (size_t)std::ceil(p * sorted.size());
+        return sorted[std::max<size_t>(rank, 1) - 1];
+    }
+    std::string encode_report(const std::string& name) const {
+        std::stringstream ss;
+        ss << name << ": " << latencies.size() << " moves, latency p50 " << percentile(0.5) * 1000
+           << "ms p95 " << percentile(0.95) * 1000 << "ms max " << percentile(1.0) * 1000 << "ms\n";
+        return ss.str();
+    }
+};
+
+std::string encode_seconds(double seconds) {
+    std::stringstream ss;
+    ss.precision(3);
+    ss << std::fixed << seconds;
+    return ss.str();
+}
+
+void launch_executable(std::string filename, double limit) {
 #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
-    size_t pos;
-    std::string command = "start /min " + filename + " " + file_state + " " + file_action;
-    if((pos = filename.rfind("/"))!=std::string::npos || (pos = filename.rfind("\\"))!=std::string::npos)
-        filename = filename.substr(pos+1, std::string::npos);
-    std::string kill = "timeout /t " + std::to_string(timeout) + " > NUL && taskkill /im " + filename + " > NUL 2>&1";
-    system(command.c_str());
-    system(kill.c_str());
+    // Wait for the player to exit and kill it at the limit, the move only costs the time it took
+    std::string command = filename + " " + file_state + " " + file_action;
+    std::vector<char> command_line(command.begin(), command.end());
+    command_line.push_back('\0');
+    STARTUPINFOA startup_info = {};
+    startup_info.cb = sizeof(startup_info);
+    startup_info.dwFlags = STARTF_USESHOWWINDOW;
+    startup_info.wShowWindow = SW_SHOWMINNOACTIVE;
+    PROCESS_INFORMATION process_info = {};
+    if (!CreateProcessA(NULL, command_line.data(), NULL, NULL, FALSE, CREATE_NEW_CONSOLE, NULL, NULL, &startup_info, &process_info)) {
+        std::cerr << "Error launching: " << filename << "\n";
+        return;
+    }
+    if (WaitForSingleObject(process_info.hProcess, (DWORD)std::ceil(limit * 1000)) == WAIT_TIMEOUT) {
+        TerminateProcess(process_info.hProcess, 1);
+        // The action file is only read after the process is gone
+        WaitForSingleObject(process_info.hProcess, INFINITE);
+    }
+    CloseHandle(process_info.hThread);
+    CloseHandle(process_info.hProcess);
 #elif __linux__
-    std::string command = "timeout " + std::to_string(timeout) + "s " + filename + " " + file_state + " " + file_action;
+    std::string command = "timeout " + encode_seconds(limit) + "s " + filename + " " + file_state + " " + file_action;
     system(command.c_str());
 #elif __APPLE__
     // May require installing the command by:
     // brew install coreutils
-    std::string command = "gtimeout " + std::to_string(timeout) + "s " + filename + " " + file_state + " " + file_action;
+    std::string command = "gtimeout " + encode_seconds(limit) + "s " + filename + " " + file_state + " " + file_action;
     system(command.c_str());
 #endif
 }
 
 int main(int argc, char** argv) {
-    assert(argc == 3);
+    // main <black> <white> [--move-time s] [--game-time s] [--increment s]
+    assert(argc >= 3 && argc % 2 == 1);
+    TimeControl time_control;
+    for (int i = 3; i + 1 < argc; i += 2) {
+        std::string option = argv[i];
+        if (option == "--move-time") time_control.move_time = atof(argv[i+1]);
+        else if (option == "--game-time") time_control.game_time = atof(argv[i+1]);
+        else if (option == "--increment") time_control.increment = atof(argv[i+1]);
+        else std::cerr << "Unknown option: " << option << "\n";
+    }
     std::ofstream log("gamelog.txt");
     std::string player_filename[3];
     player_filename[1] = argv[1];
     player_filename[2] = argv[2];
     std::cout << "Player Black File: " << player_filename[GomokuBoard::BLACK] << std::endl;
     std::cout << "Player White File: " << player_filename[GomokuBoard::WHITE] << std::endl;
+    PlayerClock clock[3];
+    clock[GomokuBoard::BLACK].remaining = time_control.game_time;
+    clock[GomokuBoard::WHITE].remaining = time_control.game_time;
     GomokuBoard game;
     std::string data;
     data = game.encode_output();
@@ -234,12 +307,23 @@ int main(int argc, char** argv) {
     log << data;
     while (!game.done) {
         // Output current state
+        PlayerClock& player_clock = clock[game.cur_player];
+        double limit = time_control.move_time;
+        if (time_control.game_time > 0)
+            limit = std::min(limit, player_clock.remaining);
         data = game.encode_state();
         std::ofstream fout(file_state);
         fout << data;
+        // Time left in ms after the board: whole game (-1 if no limit), increment, this move
+        fout << (time_control.game_time > 0 ? (long long)(player_clock.remaining * 1000) : -1) << " "
+             << (long long)(time_control.increment * 1000) << " " << (long long)(limit * 1000) << "\n";
         fout.close();
         // Run external program
-        launch_executable(player_filename[game.cur_player]);
+        auto start = std::chrono::steady_clock::now();
+        launch_executable(player_filename[game.cur_player], limit);
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        player_clock.latencies.push_back(elapsed);
+        std::cout << "Time: " << encode_seconds(elapsed) << "s\n";
         // Read action
         std::ifstream fin(file_action);
         Point p(-1, -1);
@@ -254,6 +338,18 @@ int main(int argc, char** argv) {
         // Reset action file
         if (remove(file_action.c_str()) != 0)
             std::cerr << "Error removing file: " << file_action << "\n";
+        // Check game time, the move only counts if it was made in time
+        if (time_control.game_time > 0) {
+            player_clock.remaining -= elapsed;
+            if (player_clock.remaining <= 0) {
+                game.lose_on_time();
+                data = game.encode_output(true, "Opponent ran out of time");
+                std::cout << data;
+                log << data;
+                break;
+            }
+            player_clock.remaining += time_control.increment;
+        }
         // Take action
         if (!game.put_disc(p)) {
             // If action is invalid.
@@ -266,6 +362,9 @@ int main(int argc, char** argv) {
         std::cout << data;
         log << data;
     }
+    data = clock[GomokuBoard::BLACK].encode_report("O") + clock[GomokuBoard::WHITE].encode_report("X");
+    std::cout << data;
+    log << data;
     log.close();
     // Reset state file
     if (remove(file_state.c_str()) != 0)